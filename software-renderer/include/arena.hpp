@@ -0,0 +1,65 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace sfr::arena {
+
+// allocations start on cache lines of their own and are rounded up to whole ones, so threads never
+// share a line through the arena
+constexpr size_t Alignment = 64;
+
+// Linear storage dropped as a whole. Allocations bump an offset through one block, those that do
+// not fit get blocks of their own. reset drops everything at once and swaps the block for one
+// holding the most the arena ever held when it is smaller, so once that stops growing nothing
+// reaches the heap anymore.
+struct arena_data {
+    std::byte* block = nullptr;
+    size_t capacity  = 0;
+    size_t offset    = 0;
+    std::vector<std::byte*> spills;
+
+    // bytes held since the last reset, spills included, and the most ever held
+    size_t used      = 0;
+    size_t highWater = 0;
+};
+
+// Holds bytes until the next reset, at a multiple of Alignment.
+void* allocate(arena_data& arena, size_t bytes);
+// count value initialized Ts, never destroyed, so only ones that need no destructor.
+template <typename T>
+std::span<T> allocate(arena_data& arena, size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>);
+    auto* ret = static_cast<T*>(allocate(arena, count * sizeof(T)));
+    std::uninitialized_value_construct_n(ret, count);
+    return {ret, count};
+}
+
+// Where an arena is at, rewinding to it gives back what was allocated after.
+struct marker {
+    size_t offset;
+    size_t used;
+    size_t spills;
+};
+
+marker mark(const arena_data& arena);
+// For scratch of a job: a thread runs any number of them in a frame, only one at a time needs it.
+void rewind(arena_data& arena, const marker& at);
+
+void reset(arena_data& arena);
+void destroy(arena_data& arena);
+
+// The calling thread's arena for the frame, reset the first time it is asked for after nextFrame.
+// Stages take the scratch they need for no longer than the frame from it, job pool workers from
+// their own.
+arena_data& local();
+// Ends the frame, what was taken from the local arenas is gone. Only between frames, while none
+// of it is in use.
+void nextFrame();
+
+};// namespace sfr::arena
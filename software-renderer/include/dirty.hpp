@@ -0,0 +1,59 @@
+#pragma once
+
+#include "types.hpp"
+#include "present.hpp"
+#include "texture.hpp"
+#include "math/mat.hpp"
+#include "math/vec.hpp"
+
+#include <vector>
+
+namespace sfr::dirty {
+
+// Screen space vertices of one object, kept until its transform or its vertices change.
+struct object_data {
+    mat4 transform;
+    // of the vertices the cache was built from, owners bump theirs whenever they edit them
+    u64 version;
+    bool cached;
+
+    std::vector<vec3> screen;
+    // pixels the cached vertices may cover
+    texture::rect bounds;
+};
+
+// What changed on screen and still has to be redrawn. Back buffers rotate through the present
+// queue, so the one about to be drawn also misses what the frames drawn into the others changed.
+struct tracker_data {
+    texture::rect screen;
+    int bufferCount;
+
+    // collected for the frame being built
+    texture::rect frame;
+    // of the last bufferCount - 1 frames drawn, newest first
+    texture::rect history[present::MaxBuffers];
+};
+
+// Everything starts out dirty, back buffers and persistent targets hold nothing yet.
+tracker_data create(size_t width, size_t height, int bufferCount);
+
+void damage(tracker_data& tracker, const texture::rect& area);
+// the whole screen, for changes that are not tied to an object
+void invalidate(tracker_data& tracker);
+
+// True when the cached vertices of object are not the ones of transform and version.
+bool stale(const object_data& object, const mat4& transform, u64 version);
+// Marks object up to date once its screen vertices were rebuilt, damaging the pixels it covered
+// before and the ones it covers now.
+void update(tracker_data& tracker, object_data& object, const mat4& transform, u64 version);
+
+// Whether the frame needs drawing at all, without it the one on screen is still right.
+bool pending(const tracker_data& tracker);
+// Changed since the last frame drawn, what targets kept across frames (msaa, depth) need redrawn.
+texture::rect frameArea(const tracker_data& tracker);
+// What the back buffer about to be drawn needs redrawn.
+texture::rect bufferArea(const tracker_data& tracker);
+// Once the frame is submitted.
+void advance(tracker_data& tracker);
+
+};// namespace sfr::dirty
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "types.hpp"
+#include "arena.hpp"
+#include "texture.hpp"
+
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace sfr::graph {
+
+// Index of a resource in the graph it was declared in.
+using resource = u32;
+
+struct texture_desc {
+    size_t width;
+    size_t height;
+    texture::type type;
+    texture::pixel_format format;
+};
+
+struct resource_data {
+    texture_desc desc;
+    // imported textures belong to the caller, transient ones are placed in the graph's memory
+    // by compile, data resources have neither
+    texture::texture_data texture;
+    bool transient;
+    // first and last level using it, for aliasing
+    int first, last;
+};
+
+// The resources a pass reads or writes, a braced list or an array of them. Only looked at while the
+// pass is added, which copies them.
+struct resource_list {
+    resource_list() = default;
+    resource_list(std::initializer_list<resource> list) : items(list.begin(), list.size()) {}
+    template <std::ranges::contiguous_range Range>
+    resource_list(const Range& range) : items(std::ranges::data(range), std::ranges::size(range)) {}
+
+    std::span<const resource> items;
+};
+
+// A pass runs once per tile of the first sized resource it writes, tiles of tileRows rows running
+// in parallel; the whole resource is a single tile when tileRows is 0. Passes writing nothing sized
+// get an empty tile. Its name and accesses live in the graph's storage until reset.
+struct pass_data {
+    std::string_view name;
+    std::span<const resource> reads;
+    std::span<const resource> writes;
+    std::function<void(const texture::rect& tile)> execute;
+    int tileRows;
+
+    int level;
+    bool culled;
+};
+
+// Passes in the order they were added, which is the order their accesses to a resource happen
+// in. compile puts every pass one level past the passes it has to follow (reading what they write,
+// or writing what they read or write), drops the passes nothing imported depends on, and lets
+// transient textures whose levels do not overlap share memory. execute runs the levels in order
+// and the passes of a level in parallel on the job pool.
+struct graph_data {
+    std::vector<resource_data> resources;
+    std::vector<pass_data> passes;
+    std::vector<std::span<const u32>> levels;
+    // what the passes and levels point into, dropped by reset but kept, like the vectors, so a
+    // graph built the same way every frame stops allocating after the first
+    arena::arena_data storage;
+
+    // transient memory, kept across reset and only grown
+    void* memory;
+    size_t capacity;
+    // bytes the transients of the last compile need, without aliasing they would take unaliased
+    size_t used;
+    size_t unaliased;
+};
+
+graph_data create();
+void destroy(graph_data& graph);
+
+// Drops every pass and resource, for the next frame's graph, keeping the storage they took.
+void reset(graph_data& graph);
+
+resource importTexture(graph_data& graph, texture::texture_data& tex);
+// Memory of a transient texture holds garbage until a pass writes it.
+resource createTexture(graph_data& graph, const texture_desc& desc);
+// Anything else passes share (vertex arrays, msaa storage), only ordering is tracked. A size
+// makes it something passes writing it can be tiled over.
+resource importData(graph_data& graph, size_t width = 0, size_t height = 0);
+
+void addPass(
+        graph_data& graph,
+        std::string_view name,
+        resource_list reads,
+        resource_list writes,
+        const std::function<void(const texture::rect& tile)>& execute,
+        int tileRows = 0
+);
+// Callables that need no destructor, lambdas capturing by reference among them, are copied into
+// the graph's storage and go in by reference, which std::function holds without allocating.
+template <typename Execute>
+    requires std::is_trivially_destructible_v<std::decay_t<Execute>>
+void addPass(
+        graph_data& graph,
+        std::string_view name,
+        resource_list reads,
+        resource_list writes,
+        Execute&& execute,
+        int tileRows = 0
+) {
+    using callable = std::decay_t<Execute>;
+    auto* copy     = new (arena::allocate(graph.storage, sizeof(callable))) callable(std::forward<Execute>(execute));
+    const std::function<void(const texture::rect& tile)> borrowed = std::cref(*copy);
+    addPass(graph, name, reads, writes, borrowed, tileRows);
+}
+
+void compile(graph_data& graph);
+void execute(graph_data& graph);
+
+// The texture behind a resource, transient ones valid from compile on.
+texture::texture_data& get(graph_data& graph, resource res);
+
+};// namespace sfr::graph
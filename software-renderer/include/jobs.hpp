@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+namespace sfr::jobs {
+
+// One pool of worker threads, one per core and pinned to it, shared by every stage. Each worker
+// runs jobs off its own queue and steals from the others when that runs dry, and sleeps when
+// there is nothing to steal either. Threads waiting on jobs run queued ones in the meantime.
+
+// Jobs spawned against it, a job that has to run after others waits on theirs.
+struct counter {
+    std::atomic<size_t> pending{0};
+};
+
+// Queues job, counted in done until it has run. done has to outlive it.
+void spawn(counter& done, std::function<void()> job);
+// Returns once every job counted in done has run.
+void wait(counter& done);
+
+// Runs body over [0, count) split into chunks of grain items starting at multiples of grain, and
+// returns once every chunk is done. Chunks run in no particular order, each one exactly once. The
+// range is split in halves only as far as idle threads ask for work, calls from inside a body
+// included.
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+// Any other body goes in by reference, which std::function holds without allocating.
+template <typename Body>
+void parallelFor(size_t count, size_t grain, Body&& body) {
+    const std::function<void(size_t begin, size_t end)> borrowed = std::ref(body);
+    parallelFor(count, grain, borrowed);
+}
+
+// threads parallelFor spreads over, the caller included
+size_t workerCount();
+// threads the pool starts with: one per core in the process's affinity mask, or SFR_THREADS
+size_t defaultThreads();
+// Restarts the pool with threads threads, the caller included, 0 leaves it as it is. Only while
+// no jobs are queued or running.
+void setThreads(size_t threads);
+
+};// namespace sfr::jobs
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "math/precision.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+
+namespace sfr::kernels {
+
+// Instruction sets the hot loops are built for, each one a superset of the previous.
+enum isa {
+    SSE41 = 0,
+    AVX2,
+    AVX512
+};
+
+// Edge functions and depth plane of a triangle, see raster.cpp.
+struct triangle_edges {
+    float a[3], b[3], c[3];
+    bool topLeft[3];
+    float invArea;
+    float z[3];
+};
+
+// One variant of every kernel. All variants produce bitwise identical results, except for divides
+// asked for at less than exact precision, those only stay within the bounds in math/precision.hpp.
+struct kernel_table {
+    isa target;
+
+    // count 32 bit values, dst 16 byte aligned
+    void (*fill32)(void* dst, u32 value, size_t count);
+    // count points stored 4 floats apart, through a column major 4x4 matrix, w taken as 1 and
+    // divided out at the given precision when project is set
+    void (*transformPoints)(
+            const float* m,
+            const float* src,
+            float* dst,
+            size_t count,
+            bool project,
+            precision divide
+    );
+    // pshufb over runs of 4 pixels of 4 bytes, count a multiple of 4
+    void (*shuffle32)(const u32* src, u32* dst, size_t count, const u8* control);
+    // depth tested fill of the pixels of row y between minX and maxX, on packed color and float
+    // depth rows padded to whole quads and 16 byte aligned. With equal set only pixels holding
+    // exactly the triangle's depth pass and depth is left alone, for shading after depthRow.
+    void (*fillRow)(
+            const triangle_edges& tri,
+            int y,
+            int minX,
+            int maxX,
+            float* depths,
+            u32* colors,
+            u32 packed,
+            bool equal
+    );
+    // the depths fillRow would compute, kept as the per pixel minimum, no color
+    void (*depthRow)(const triangle_edges& tri, int y, int minX, int maxX, float* depths);
+    // fillRow and depthRow over pixels known to be inside the triangle, skipping the edge tests,
+    // same depths
+    void (*fillCovered)(
+            const triangle_edges& tri,
+            int y,
+            int minX,
+            int maxX,
+            float* depths,
+            u32* colors,
+            u32 packed,
+            bool equal
+    );
+    void (*depthCovered)(const triangle_edges& tri, int y, int minX, int maxX, float* depths);
+};
+
+isa detect();
+// The instruction set in use, the best one detected unless lowered through select() or the
+// SFR_ISA environment variable (sse4.1, avx2 or avx512).
+isa active();
+// Limits dispatch to target, returns what is actually used when the cpu falls short of it.
+isa select(isa target);
+const char* name(isa target);
+
+const kernel_table& get();
+const kernel_table& get(isa target);
+
+};// namespace sfr::kernels
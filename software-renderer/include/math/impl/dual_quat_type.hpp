@@ -0,0 +1,39 @@
+#pragma once
+
+#include "quat_type.hpp"
+
+// Rotation followed by translation as real + eps dual, with dual = 0.5 * (t, 0) * real. Blending
+// dual quaternions and normalizing keeps the result a rigid transform, unlike blending matrices,
+// which is what skinning relies on.
+template <typename T>
+struct dual_quaternion {
+    quaternion<T> real;
+    quaternion<T> dual;
+
+    dual_quaternion() = default;
+    constexpr dual_quaternion(const quaternion<T>& real, const quaternion<T>& dual);
+    dual_quaternion(const quaternion<T>& rotation, const vec<T, 3>& translation);
+
+    static constexpr dual_quaternion<T> identity();
+};
+
+// a * b applies b first and a after
+template <typename T>
+dual_quaternion<T> operator*(const dual_quaternion<T>& a, const dual_quaternion<T>& b);
+template <typename T>
+dual_quaternion<T> operator+(const dual_quaternion<T>& a, const dual_quaternion<T>& b);
+template <typename T>
+dual_quaternion<T> operator*(const float& s, const dual_quaternion<T>& a);
+
+// unit real part, the dual part scaled along
+template <precision P = precision::exact, typename T>
+dual_quaternion<T> normalize(const dual_quaternion<T>& a);
+
+template <typename T>
+vec<T, 3> translation(const dual_quaternion<T>& a);
+
+// p rotated then translated, a normalized
+template <typename T>
+vec<T, 3> transformPoint(const dual_quaternion<T>& a, const vec<T, 3>& p);
+
+#include "dual_quat_type.inl"
@@ -0,0 +1,54 @@
+#include "dual_quat_type.hpp"
+
+template <typename T>
+constexpr dual_quaternion<T>::dual_quaternion(const quaternion<T>& real, const quaternion<T>& dual)
+    : real(real), dual(dual) {}
+
+template <typename T>
+dual_quaternion<T>::dual_quaternion(const quaternion<T>& rotation, const vec<T, 3>& translation)
+    : real(rotation), dual(quaternion<T>(0.5f * translation, 0.f) * rotation) {}
+
+template <typename T>
+constexpr dual_quaternion<T> dual_quaternion<T>::identity() {
+    return dual_quaternion<T>(quaternion<T>::identity(), quaternion<T>(0.f, 0.f, 0.f, 0.f));
+}
+
+template <typename T>
+dual_quaternion<T> operator*(const dual_quaternion<T>& a, const dual_quaternion<T>& b) {
+    return dual_quaternion<T>(a.real * b.real, a.real * b.dual + a.dual * b.real);
+}
+
+template <typename T>
+dual_quaternion<T> operator+(const dual_quaternion<T>& a, const dual_quaternion<T>& b) {
+    return dual_quaternion<T>(a.real + b.real, a.dual + b.dual);
+}
+
+template <typename T>
+dual_quaternion<T> operator*(const float& s, const dual_quaternion<T>& a) {
+    return dual_quaternion<T>(s * a.real, s * a.dual);
+}
+
+template <precision P, typename T>
+dual_quaternion<T> normalize(const dual_quaternion<T>& a) {
+    auto sum = _mm_dp_ps(a.real, a.real, 0xFF);
+    __m128 scale;
+    if constexpr (P == precision::exact) {
+        scale = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(sum));
+    } else {
+        scale = detail::reciprocalSqrt<P>(sum);
+    }
+    auto real = quaternion<T>(_mm_mul_ps(a.real, scale));
+    auto dual = quaternion<T>(_mm_mul_ps(a.dual, scale));
+    return dual_quaternion<T>(real, dual);
+}
+
+template <typename T>
+vec<T, 3> translation(const dual_quaternion<T>& a) {
+    auto t = a.dual * conjugate(a.real);
+    return 2.f * t.vector();
+}
+
+template <typename T>
+vec<T, 3> transformPoint(const dual_quaternion<T>& a, const vec<T, 3>& p) {
+    return rotate(a.real, p) + translation(a);
+}
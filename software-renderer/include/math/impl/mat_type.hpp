@@ -2,6 +2,8 @@
 
 #include "storage.hpp"
 
+#include <span>
+
 template <typename T, size_t Size>
 struct vec;
 
@@ -11,25 +13,39 @@ struct mat {
     storage<T, Size> data[Size];
 
     mat() = default;
-    mat(const T& diag);
+    constexpr mat(const T& diag);
     mat(const vec<T, 2>& v1, const vec<T, 2>& v2, const vec<T, 2>& v3);
 
-    storage<T, Size>& operator[](size_t index);
-    const storage<T, Size>& operator[](size_t index) const;
+    constexpr storage<T, Size>& operator[](size_t index);
+    constexpr const storage<T, Size>& operator[](size_t index) const;
 
     mat<T, Size>& operator*=(const mat<T, Size>& other);
 
     template <typename V, size_t VSize>
-    friend mat<V, VSize> operator+(const mat<V, VSize>& a, const mat<V, VSize>& b);
+    friend constexpr mat<V, VSize> operator+(const mat<V, VSize>& a, const mat<V, VSize>& b);
     template <typename V, size_t VSize>
-    friend mat<V, VSize> operator-(const mat<V, VSize>& a, const mat<V, VSize>& b);
+    friend constexpr mat<V, VSize> operator-(const mat<V, VSize>& a, const mat<V, VSize>& b);
     template <typename V, size_t VSize>
-    friend mat<V, VSize> operator*(const mat<V, VSize>& a, const mat<V, VSize>& b);
+    friend constexpr mat<V, VSize> operator*(const mat<V, VSize>& a, const mat<V, VSize>& b);
     template <typename V, size_t VSize>
-    friend vec<V, VSize> operator*(const mat<V, VSize>& m, const vec<V, VSize>& v);
+    friend constexpr vec<V, VSize> operator*(const mat<V, VSize>& m, const vec<V, VSize>& v);
 };
 
+template <typename T, size_t Size>
+constexpr mat<T, Size> transpose(const mat<T, Size>& m);
+
 template <typename T>
 T det(mat<T, 3> m);
 
+template <typename T>
+mat<T, 4> inverse(const mat<T, 4>& m);
+
+// Faster inverse for rotation, scale and translation, the bottom row has to be 0, 0, 0, 1.
+template <typename T>
+mat<T, 4> affineInverse(const mat<T, 4>& m);
+
+// Points with w taken as 1, out has room for at least as many as in holds.
+template <typename T>
+void transform(const mat<T, 4>& m, std::span<const vec<T, 3>> in, std::span<vec<T, 4>> out);
+
 #include "mat_type.inl"
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include "mat_type.hpp"
 
+#include <cassert>
 #include <iostream>
 #include <smmintrin.h>
+#include <type_traits>
 
 template <typename T, size_t Size>
-mat<T, Size>::mat(const T& diag) {
+constexpr mat<T, Size>::mat(const T& diag) {
     for (int i = 0; i < Size; i++) {
         data[i][i] = diag;
     }
@@ -24,13 +26,13 @@ mat<T, Size>::mat(const vec<T, 2>& v1, const vec<T, 2>& v2, const vec<T, 2>& v3)
 }
 
 template <typename T, size_t Size>
-storage<T, Size>& mat<T, Size>::operator[](size_t index) {
+constexpr storage<T, Size>& mat<T, Size>::operator[](size_t index) {
     assert(index >= 0 && index < Size);
     return data[index];
 }
 
 template <typename T, size_t Size>
-const storage<T, Size>& mat<T, Size>::operator[](size_t index) const {
+constexpr const storage<T, Size>& mat<T, Size>::operator[](size_t index) const {
     assert(index >= 0 && index < Size);
     return data[index];
 }
@@ -42,95 +44,216 @@ mat<T, Size>& mat<T, Size>::operator*=(const mat<T, Size>& other) {
 }
 
 template <typename T, size_t Size>
-mat<T, Size> operator+(const mat<T, Size>& a, const mat<T, Size>& b) {
+constexpr mat<T, Size> operator+(const mat<T, Size>& a, const mat<T, Size>& b) {
     mat<T, Size> result;
     for (int i = 0; i < Size; i++) {
-        result[i] = _mm_add_ps(a[i], b[i]);
+        if (std::is_constant_evaluated()) {
+            for (int j = 0; j < Size; j++) {
+                result[i][j] = a[i][j] + b[i][j];
+            }
+        } else {
+            result[i] = _mm_add_ps(a[i], b[i]);
+        }
     }
     return result;
 }
 
 template <typename T, size_t Size>
-mat<T, Size> operator-(const mat<T, Size>& a, const mat<T, Size>& b) {
+constexpr mat<T, Size> operator-(const mat<T, Size>& a, const mat<T, Size>& b) {
     mat<T, Size> result;
     for (int i = 0; i < Size; i++) {
-        result[i] = _mm_sub_ps(a[i], b[i]);
+        if (std::is_constant_evaluated()) {
+            for (int j = 0; j < Size; j++) {
+                result[i][j] = a[i][j] - b[i][j];
+            }
+        } else {
+            result[i] = _mm_sub_ps(a[i], b[i]);
+        }
     }
     return result;
 }
 
-template <typename T, size_t Size>
-mat<T, Size> operator*(const mat<T, Size>& a, const mat<T, Size>& b) {
-    mat<T, Size> result;
+namespace detail {
 
-    __m128 row[4];
-    for (int i = 0; i < 4; i++) {
-        if (i >= Size) {
-            row[i] = _mm_set1_ps(0);
-            continue;
-        }
-        row[i] = a[i];
+// sum of the columns weighted by the lanes of v, added in pairs
+template <typename T, size_t Size>
+__m128 combineColumns(const storage<T, Size>* columns, __m128 v) {
+    __m128 lo = _mm_add_ps(
+            _mm_mul_ps(columns[0], _mm_shuffle_ps(v, v, 0x00)),
+            _mm_mul_ps(columns[1], _mm_shuffle_ps(v, v, 0x55))
+    );
+    if constexpr (Size == 3) {
+        lo = _mm_add_ps(lo, _mm_mul_ps(columns[2], _mm_shuffle_ps(v, v, 0xAA)));
+    } else if constexpr (Size == 4) {
+        auto hi = _mm_add_ps(
+                _mm_mul_ps(columns[2], _mm_shuffle_ps(v, v, 0xAA)),
+                _mm_mul_ps(columns[3], _mm_shuffle_ps(v, v, 0xFF))
+        );
+        lo = _mm_add_ps(lo, hi);
     }
+    return lo;
+}
 
-    for (int i = 0; i < 4; i++) {
-        __m128 brod[4];
-        for (int j = 0; j < 4; j++) {
-            if (i >= Size || j >= Size) {
-                brod[j] = _mm_set1_ps(0);
-            } else {
-                brod[j] = _mm_set1_ps(b[i][j]);
-            }
-        }
+// cross product of the first three lanes, the fourth ends up zero
+inline __m128 cross3(__m128 u, __m128 v) {
+    auto uYZX = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1));
+    auto vYZX = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+    auto res  = _mm_sub_ps(_mm_mul_ps(u, vYZX), _mm_mul_ps(uYZX, v));
+    return _mm_shuffle_ps(res, res, _MM_SHUFFLE(3, 0, 2, 1));
+}
 
-        auto currRow = _mm_add_ps(
-                _mm_add_ps(_mm_mul_ps(brod[0], row[0]), _mm_mul_ps(brod[1], row[1])),
-                _mm_add_ps(_mm_mul_ps(brod[2], row[2]), _mm_mul_ps(brod[3], row[3]))
-        );
+inline __m128 dot3(__m128 u, __m128 v) { return _mm_dp_ps(u, v, 0x7F); }
+
+// the same sums as combineColumns, in the same order, for constant evaluation
+template <typename T, size_t Size>
+constexpr T combineColumnsScalar(const storage<T, Size>* columns, const storage<T, Size>& v, size_t row) {
+    T lo = columns[0][row] * v[0] + columns[1][row] * v[1];
+    if constexpr (Size == 3) {
+        lo = lo + columns[2][row] * v[2];
+    } else if constexpr (Size == 4) {
+        lo = lo + (columns[2][row] * v[2] + columns[3][row] * v[3]);
+    }
+    return lo;
+}
+
+};// namespace detail
 
-        if (i < Size) {
-            result[i] = currRow;
+template <typename T, size_t Size>
+constexpr mat<T, Size> operator*(const mat<T, Size>& a, const mat<T, Size>& b) {
+    mat<T, Size> result;
+    for (int i = 0; i < Size; i++) {
+        if (std::is_constant_evaluated()) {
+            for (int j = 0; j < Size; j++) {
+                result[i][j] = detail::combineColumnsScalar(a.data, b[i], j);
+            }
+        } else {
+            result[i] = detail::combineColumns(a.data, b[i]);
         }
     }
     return result;
 }
 
 template <typename T, size_t Size>
-vec<T, Size> operator*(const mat<T, Size>& m, const vec<T, Size>& v) {
-    vec<T, Size> result;
-
-    __m128 row[4];
-    for (int i = 0; i < 4; i++) {
-        if (i >= Size) {
-            row[i] = _mm_set1_ps(0);
-            continue;
+constexpr vec<T, Size> operator*(const mat<T, Size>& m, const vec<T, Size>& v) {
+    if (std::is_constant_evaluated()) {
+        vec<T, Size> result;
+        for (int j = 0; j < Size; j++) {
+            result[j] = detail::combineColumnsScalar(m.data, v.data, j);
         }
-        row[i] = m[i];
+        return result;
     }
+    return detail::combineColumns(m.data, v);
+}
 
-    __m128 brod[4];
-    for (int i = 0; i < 4; i++) {
-        if (i >= Size) {
-            brod[i] = _mm_set1_ps(0);
-            continue;
+template <typename T, size_t Size>
+constexpr mat<T, Size> transpose(const mat<T, Size>& m) {
+    mat<T, Size> result;
+    if constexpr (Size == 4) {
+        if (!std::is_constant_evaluated()) {
+            __m128 c0 = m[0], c1 = m[1], c2 = m[2], c3 = m[3];
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            result[0] = c0;
+            result[1] = c1;
+            result[2] = c2;
+            result[3] = c3;
+            return result;
         }
-
-        brod[i] = _mm_set1_ps(v[i]);
     }
 
-    auto regRes = _mm_add_ps(
-            _mm_add_ps(_mm_mul_ps(brod[0], row[0]), _mm_mul_ps(brod[1], row[1])),
-            _mm_add_ps(_mm_mul_ps(brod[2], row[2]), _mm_mul_ps(brod[3], row[3]))
-    );
-
-    float buffer[4];
-    _mm_store_ps(buffer, regRes);
     for (int i = 0; i < Size; i++) {
-        result[i] = buffer[i];
+        for (int j = 0; j < Size; j++) {
+            result[i][j] = m[j][i];
+        }
     }
+    return result;
+}
+
+// Cofactors from the cross products of the column pairs, see Lengyel, Foundations of Game
+// Engine Development vol. 1, listing 1.11. Lanes 0-2 of a column are its upper 3x3 part, the
+// bottom row x, y, z, w sits in lane 3.
+template <typename T>
+mat<T, 4> inverse(const mat<T, 4>& m) {
+    __m128 a = m[0], b = m[1], c = m[2], d = m[3];
+    auto x   = _mm_shuffle_ps(a, a, 0xFF);
+    auto y   = _mm_shuffle_ps(b, b, 0xFF);
+    auto z   = _mm_shuffle_ps(c, c, 0xFF);
+    auto w   = _mm_shuffle_ps(d, d, 0xFF);
+
+    auto s = detail::cross3(a, b);
+    auto t = detail::cross3(c, d);
+    auto u = _mm_sub_ps(_mm_mul_ps(a, y), _mm_mul_ps(b, x));
+    auto v = _mm_sub_ps(_mm_mul_ps(c, w), _mm_mul_ps(d, z));
+
+    auto invDet = _mm_div_ps(_mm_set1_ps(1.f), _mm_add_ps(detail::dot3(s, v), detail::dot3(t, u)));
+    s = _mm_mul_ps(s, invDet);
+    t = _mm_mul_ps(t, invDet);
+    u = _mm_mul_ps(u, invDet);
+    v = _mm_mul_ps(v, invDet);
+
+    auto negate = _mm_set1_ps(-0.f);
+    auto r0     = _mm_add_ps(detail::cross3(b, v), _mm_mul_ps(t, y));
+    auto r1     = _mm_sub_ps(detail::cross3(v, a), _mm_mul_ps(t, x));
+    auto r2     = _mm_add_ps(detail::cross3(d, u), _mm_mul_ps(s, w));
+    auto r3     = _mm_sub_ps(detail::cross3(u, c), _mm_mul_ps(s, z));
+
+    // the rows of the inverse, the last column from the dot products in lane 3
+    r0 = _mm_blend_ps(r0, _mm_xor_ps(detail::dot3(b, t), negate), 0x8);
+    r1 = _mm_blend_ps(r1, detail::dot3(a, t), 0x8);
+    r2 = _mm_blend_ps(r2, _mm_xor_ps(detail::dot3(d, s), negate), 0x8);
+    r3 = _mm_blend_ps(r3, detail::dot3(c, s), 0x8);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
 
+    mat<T, 4> result;
+    result[0] = r0;
+    result[1] = r1;
+    result[2] = r2;
+    result[3] = r3;
     return result;
 }
 
+template <typename T>
+mat<T, 4> affineInverse(const mat<T, 4>& m) {
+    __m128 a = m[0], b = m[1], c = m[2], t = m[3];
+
+    // the rows of the inverse of the upper 3x3 part are the cross products of its columns
+    auto r0     = detail::cross3(b, c);
+    auto r1     = detail::cross3(c, a);
+    auto r2     = detail::cross3(a, b);
+    auto invDet = _mm_div_ps(_mm_set1_ps(1.f), detail::dot3(a, r0));
+    r0          = _mm_mul_ps(r0, invDet);
+    r1          = _mm_mul_ps(r1, invDet);
+    r2          = _mm_mul_ps(r2, invDet);
+
+    auto negate = _mm_set1_ps(-0.f);
+    r0 = _mm_blend_ps(r0, _mm_xor_ps(detail::dot3(r0, t), negate), 0x8);
+    r1 = _mm_blend_ps(r1, _mm_xor_ps(detail::dot3(r1, t), negate), 0x8);
+    r2 = _mm_blend_ps(r2, _mm_xor_ps(detail::dot3(r2, t), negate), 0x8);
+    auto r3 = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    mat<T, 4> result;
+    result[0] = r0;
+    result[1] = r1;
+    result[2] = r2;
+    result[3] = r3;
+    return result;
+}
+
+template <typename T>
+void transform(const mat<T, 4>& m, std::span<const vec<T, 3>> in, std::span<vec<T, 4>> out) {
+    assert(out.size() >= in.size());
+
+    for (size_t i = 0; i < in.size(); i++) {
+        __m128 p = in[i];
+        auto xy  = _mm_add_ps(
+                _mm_mul_ps(m[0], _mm_shuffle_ps(p, p, 0x00)),
+                _mm_mul_ps(m[1], _mm_shuffle_ps(p, p, 0x55))
+        );
+        auto zw = _mm_add_ps(_mm_mul_ps(m[2], _mm_shuffle_ps(p, p, 0xAA)), m[3]);
+        out[i]  = _mm_add_ps(xy, zw);
+    }
+}
+
 template <typename T>
 T det(mat<T, 3> m) {
     static __m128 cofactors = _mm_set_ps(0, 1, -1, 1);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../precision.hpp"
+#include "mat_type.hpp"
+#include "vec3_type.hpp"
+#include "vec4_type.hpp"
+
+#include <type_traits>
+
+// Rotation x, y, z, w with w the real part, in one register like vec4. Only unit quaternions are
+// rotations, the products of two stay unit up to rounding, normalize now and then when chaining.
+template <typename T>
+struct quaternion {
+    static_assert(std::is_same<T, float>::value, "Only float quaternions are supported!");
+
+    typedef T type;
+
+    union {
+        storage<T, 4> data{};
+        struct {
+            T x, y, z, w;
+        };
+    };
+
+    quaternion() = default;
+    constexpr quaternion(const T& x, const T& y, const T& z, const T& w);
+    constexpr quaternion(const vec<T, 3>& v, const T& w);
+    quaternion(const __m128& reg);
+
+    static constexpr quaternion<T> identity();
+
+    operator __m128() const;
+
+    constexpr vec<T, 3> vector() const;
+};
+
+// angle in degrees like rotateOX, counter clockwise around axis, axis of unit length
+template <typename T>
+quaternion<T> angleAxis(float angle, const vec<T, 3>& axis);
+
+// Hamilton product, q * p rotates by p first and q after
+template <typename T>
+quaternion<T> operator*(const quaternion<T>& q, const quaternion<T>& p);
+template <typename T>
+quaternion<T> operator+(const quaternion<T>& q, const quaternion<T>& p);
+template <typename T>
+quaternion<T> operator*(const float& s, const quaternion<T>& q);
+
+template <typename T>
+quaternion<T> conjugate(const quaternion<T>& q);
+template <typename T>
+float dot(const quaternion<T>& q, const quaternion<T>& p);
+template <precision P = precision::exact, typename T>
+quaternion<T> normalize(const quaternion<T>& q);
+
+// v rotated by the unit quaternion q, cheaper than q * v * conjugate(q)
+template <typename T>
+vec<T, 3> rotate(const quaternion<T>& q, const vec<T, 3>& v);
+
+// normalized lerp along the shorter arc, t in [0, 1]
+template <typename T>
+quaternion<T> nlerp(const quaternion<T>& q, const quaternion<T>& p, float t);
+
+#include "quat_type.inl"
@@ -0,0 +1,116 @@
+#include "quat_type.hpp"
+
+#include "vec_detail.hpp"
+
+#include <cmath>
+
+template <typename T>
+constexpr quaternion<T>::quaternion(const T& x, const T& y, const T& z, const T& w) {
+    data[0] = x;
+    data[1] = y;
+    data[2] = z;
+    data[3] = w;
+}
+
+template <typename T>
+constexpr quaternion<T>::quaternion(const vec<T, 3>& v, const T& w) {
+    data[0] = v[0];
+    data[1] = v[1];
+    data[2] = v[2];
+    data[3] = w;
+}
+
+template <typename T>
+quaternion<T>::quaternion(const __m128& reg) {
+    data = storage<T, 4>(reg);
+}
+
+template <typename T>
+constexpr quaternion<T> quaternion<T>::identity() {
+    return quaternion<T>(0.f, 0.f, 0.f, 1.f);
+}
+
+template <typename T>
+quaternion<T>::operator __m128() const {
+    return data;
+}
+
+template <typename T>
+constexpr vec<T, 3> quaternion<T>::vector() const {
+    return vec<T, 3>(data[0], data[1], data[2]);
+}
+
+template <typename T>
+quaternion<T> angleAxis(float angle, const vec<T, 3>& axis) {
+    auto half = angle * float(M_PI / 360);
+    return quaternion<T>(std::sin(half) * axis, std::cos(half));
+}
+
+// (qw pv + pw qv + qv x pv, qw pw - qv . pv), the w row of every term but the first flips sign
+template <typename T>
+quaternion<T> operator*(const quaternion<T>& q, const quaternion<T>& p) {
+    __m128 a = q, b = p;
+    auto flipW = _mm_set_ps(-0.f, 0.f, 0.f, 0.f);
+
+    auto res = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+    auto t0  = _mm_mul_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 0)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 3, 3))
+    );
+    auto t1  = _mm_mul_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 2, 1)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 0, 2))
+    );
+    auto t2  = _mm_mul_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 0, 2)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 0, 2, 1))
+    );
+    res = _mm_add_ps(res, _mm_xor_ps(_mm_add_ps(t0, t1), flipW));
+    return _mm_sub_ps(res, t2);
+}
+
+template <typename T>
+quaternion<T> operator+(const quaternion<T>& q, const quaternion<T>& p) {
+    return _mm_add_ps(q, p);
+}
+
+template <typename T>
+quaternion<T> operator*(const float& s, const quaternion<T>& q) {
+    return _mm_mul_ps(_mm_set1_ps(s), q);
+}
+
+template <typename T>
+quaternion<T> conjugate(const quaternion<T>& q) {
+    return _mm_xor_ps(q, _mm_set_ps(0.f, -0.f, -0.f, -0.f));
+}
+
+template <typename T>
+float dot(const quaternion<T>& q, const quaternion<T>& p) {
+    return _mm_cvtss_f32(_mm_dp_ps(q, p, 0xF1));
+}
+
+template <precision P, typename T>
+quaternion<T> normalize(const quaternion<T>& q) {
+    auto sum = _mm_dp_ps(q, q, 0xFF);
+    if constexpr (P == precision::exact) {
+        return _mm_div_ps(q, _mm_sqrt_ps(sum));
+    }
+    return _mm_mul_ps(q, detail::reciprocalSqrt<P>(sum));
+}
+
+// v + 2 w (q x v) + 2 q x (q x v), with t = 2 (q x v)
+template <typename T>
+vec<T, 3> rotate(const quaternion<T>& q, const vec<T, 3>& v) {
+    __m128 r = q;
+    auto t   = detail::cross3(r, v);
+    t        = _mm_add_ps(t, t);
+    auto w   = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(w, t)), detail::cross3(r, t));
+}
+
+template <typename T>
+quaternion<T> nlerp(const quaternion<T>& q, const quaternion<T>& p, float t) {
+    // q and -q are the same rotation, the one closer to q takes the short way round
+    auto s = dot(q, p) < 0.f ? -t : t;
+    return normalize<precision::fast>((1.f - t) * q + s * p);
+}
@@ -10,16 +10,42 @@ struct storage {
     //storage(Args&&... args);
     storage() = default;
     storage(const __m128& reg);
-    storage(const storage<T, Size>& other);
+    constexpr storage(const storage<T, Size>& other);
 
     storage<T, Size>& operator=(const __m128& reg);
-    storage<T, Size>& operator=(const storage<T, Size>& other);
+    constexpr storage<T, Size>& operator=(const storage<T, Size>& other);
 
     operator T*();
     operator __m128() const;
 
-    T& operator[](size_t index);
-    const T& operator[](size_t index) const;
+    constexpr T& operator[](size_t index);
+    constexpr const T& operator[](size_t index) const;
+};
+
+// Float vectors and matrix columns live in a full, 16 byte aligned register. Lanes past Size are
+// padding, they take part in the arithmetic but never in comparisons or reductions. The float
+// array is the member constant evaluation writes through, the register aliases it at run time.
+template <size_t Size>
+struct storage<float, Size> {
+    static_assert(Size <= 4, "Float storage holds at most 4 components!");
+
+    union {
+        alignas(16) float data[4]{};
+        __m128 reg;
+    };
+
+    storage() = default;
+    storage(const __m128& reg);
+    storage(const storage<float, Size>& other) = default;
+
+    storage<float, Size>& operator=(const __m128& reg);
+    storage<float, Size>& operator=(const storage<float, Size>& other) = default;
+
+    operator float*();
+    operator __m128() const;
+
+    constexpr float& operator[](size_t index);
+    constexpr const float& operator[](size_t index) const;
 };
 
 #include "storage.inl"
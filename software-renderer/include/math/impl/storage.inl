@@ -25,7 +25,7 @@ storage<T, Size>::storage(const __m128& reg) {
 }
 
 template <typename T, size_t Size>
-storage<T, Size>::storage(const storage<T, Size>& other) {
+constexpr storage<T, Size>::storage(const storage<T, Size>& other) {
     for (int i = 0; i < Size; i++) {
         this->data[i] = other.data[i];
     }
@@ -44,7 +44,7 @@ storage<T, Size>& storage<T, Size>::operator=(const __m128& reg) {
 }
 
 template <typename T, size_t Size>
-storage<T, Size>& storage<T, Size>::operator=(const storage<T, Size>& other) {
+constexpr storage<T, Size>& storage<T, Size>::operator=(const storage<T, Size>& other) {
     for (int i = 0; i < Size; i++) {
         this->data[i] = other.data[i];
     }
@@ -74,13 +74,46 @@ storage<T, Size>::operator __m128() const {
 }
 
 template <typename T, size_t Size>
-T& storage<T, Size>::operator[](size_t index) {
+constexpr T& storage<T, Size>::operator[](size_t index) {
     assert(index >= 0 && index < Size);
     return data[index];
 }
 
 template <typename T, size_t Size>
-const T& storage<T, Size>::operator[](size_t index) const {
+constexpr const T& storage<T, Size>::operator[](size_t index) const {
+    assert(index >= 0 && index < Size);
+    return data[index];
+}
+
+template <size_t Size>
+storage<float, Size>::storage(const __m128& reg) {
+    this->reg = reg;
+}
+
+template <size_t Size>
+storage<float, Size>& storage<float, Size>::operator=(const __m128& reg) {
+    this->reg = reg;
+    return *this;
+}
+
+template <size_t Size>
+storage<float, Size>::operator float*() {
+    return data;
+}
+
+template <size_t Size>
+storage<float, Size>::operator __m128() const {
+    return reg;
+}
+
+template <size_t Size>
+constexpr float& storage<float, Size>::operator[](size_t index) {
+    assert(index >= 0 && index < Size);
+    return data[index];
+}
+
+template <size_t Size>
+constexpr const float& storage<float, Size>::operator[](size_t index) const {
     assert(index >= 0 && index < Size);
     return data[index];
 }
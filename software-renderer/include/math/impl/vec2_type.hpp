@@ -16,20 +16,20 @@ struct vec<T, 2> {
     };
 
     vec() = default;
-    vec(const T& value);
-    vec(const T& x, const T& y);
+    constexpr vec(const T& value);
+    constexpr vec(const T& x, const T& y);
     vec(const __m128& reg);
-    vec(const vec<T, 2>& other);
-    vec(const vec<T, 3>& other);
-    vec(const vec<T, 4>& other);
+    constexpr vec(const vec<T, 2>& other);
+    constexpr vec(const vec<T, 3>& other);
+    constexpr vec(const vec<T, 4>& other);
 
-    vec<T, 2>& operator=(const vec<T, 2>& other);
+    constexpr vec<T, 2>& operator=(const vec<T, 2>& other);
 
     operator T*();
     operator __m128() const;
 
-    T& operator[](size_t index);
-    const T& operator[](size_t index) const;
+    constexpr T& operator[](size_t index);
+    constexpr const T& operator[](size_t index) const;
 
     vec<T, 2>& operator+=(const vec<T, 2>& v);
     vec<T, 2>& operator-=(const vec<T, 2>& v);
@@ -4,30 +4,30 @@
 #include <cassert>
 
 template <typename T>
-vec<T, 2>::vec(const T& value) {
+constexpr vec<T, 2>::vec(const T& value) {
     data[0] = value;
     data[1] = value;
 }
 
 template <typename T>
-vec<T, 2>::vec(const T& x, const T& y) {
+constexpr vec<T, 2>::vec(const T& x, const T& y) {
     data[0] = x;
     data[1] = y;
 }
 
 template <typename T>
-vec<T, 2>::vec(const vec<T, 2>& other) {
+constexpr vec<T, 2>::vec(const vec<T, 2>& other) {
     this->data = other.data;
 }
 
 template <typename T>
-vec<T, 2>::vec(const vec<T, 3>& other) {
+constexpr vec<T, 2>::vec(const vec<T, 3>& other) {
     this->data[0] = other.data[0];
     this->data[1] = other.data[1];
 }
 
 template <typename T>
-vec<T, 2>::vec(const vec<T, 4>& other) {
+constexpr vec<T, 2>::vec(const vec<T, 4>& other) {
     this->data[0] = other.data[0];
     this->data[1] = other.data[1];
 }
@@ -38,7 +38,7 @@ vec<T, 2>::vec(const __m128& reg) {
 }
 
 template <typename T>
-vec<T, 2>& vec<T, 2>::operator=(const vec<T, 2>& other) {
+constexpr vec<T, 2>& vec<T, 2>::operator=(const vec<T, 2>& other) {
     this->data = other.data;
     return *this;
 }
@@ -54,7 +54,7 @@ vec<T, 2>::operator __m128() const {
 }
 
 template <typename T>
-T& vec<T, 2>::operator[](size_t index) {
+constexpr T& vec<T, 2>::operator[](size_t index) {
     return data[index];
 }
 
@@ -94,7 +94,7 @@ bool operator!=(const vec<T, 2>& u, const vec<T, 2>& v) {
 }
 
 template <typename T>
-const T& vec<T, 2>::operator[](size_t index) const {
+constexpr const T& vec<T, 2>::operator[](size_t index) const {
     return data[index];
 }
 
@@ -17,19 +17,19 @@ struct vec<T, 3> {
     };
 
     vec() = default;
-    vec(const T& value);
-    vec(const T& x, const T& y, const T& z);
+    constexpr vec(const T& value);
+    constexpr vec(const T& x, const T& y, const T& z);
     vec(const __m128& reg);
-    vec(const vec<T, 3>& other);
-    vec(const vec<T, 4>& other);
+    constexpr vec(const vec<T, 3>& other);
+    constexpr vec(const vec<T, 4>& other);
 
-    vec<T, 3>& operator=(const vec<T, 3>& other);
+    constexpr vec<T, 3>& operator=(const vec<T, 3>& other);
 
     operator T*();
     operator __m128() const;
 
-    T& operator[](size_t index);
-    const T& operator[](size_t index) const;
+    constexpr T& operator[](size_t index);
+    constexpr const T& operator[](size_t index) const;
 
     vec<T, 3>& operator+=(const vec<T, 3>& v);
     vec<T, 3>& operator-=(const vec<T, 3>& v);
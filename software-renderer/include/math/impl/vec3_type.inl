@@ -4,14 +4,14 @@
 #include <cassert>
 
 template <typename T>
-vec<T, 3>::vec(const T& value) {
+constexpr vec<T, 3>::vec(const T& value) {
     data[0] = value;
     data[1] = value;
     data[2] = value;
 }
 
 template <typename T>
-vec<T, 3>::vec(const T& x, const T& y, const T& z) {
+constexpr vec<T, 3>::vec(const T& x, const T& y, const T& z) {
     data[0] = x;
     data[1] = y;
     data[2] = z;
@@ -23,19 +23,19 @@ vec<T, 3>::vec(const __m128& reg) {
 }
 
 template <typename T>
-vec<T, 3>::vec(const vec<T, 3>& other) {
+constexpr vec<T, 3>::vec(const vec<T, 3>& other) {
     this->data = other.data;
 }
 
 template <typename T>
-vec<T, 3>::vec(const vec<T, 4>& other) {
+constexpr vec<T, 3>::vec(const vec<T, 4>& other) {
     this->data[0] = other.data[0];
     this->data[1] = other.data[1];
     this->data[2] = other.data[2];
 }
 
 template <typename T>
-vec<T, 3>& vec<T, 3>::operator=(const vec<T, 3>& other) {
+constexpr vec<T, 3>& vec<T, 3>::operator=(const vec<T, 3>& other) {
     this->data = other.data;
     return *this;
 }
@@ -51,7 +51,7 @@ vec<T, 3>::operator __m128() const {
 }
 
 template <typename T>
-T& vec<T, 3>::operator[](size_t index) {
+constexpr T& vec<T, 3>::operator[](size_t index) {
     return data[index];
 }
 
@@ -91,7 +91,7 @@ bool operator!=(const vec<T, 3>& u, const vec<T, 3>& v) {
 }
 
 template <typename T>
-const T& vec<T, 3>::operator[](size_t index) const {
+constexpr const T& vec<T, 3>::operator[](size_t index) const {
     return data[index];
 }
 
@@ -18,20 +18,20 @@ struct vec<T, 4> {
     };
 
     vec() = default;
-    vec(const T& value);
-    vec(const T& x, const T& y, const T& z, const T& w);
+    constexpr vec(const T& value);
+    constexpr vec(const T& x, const T& y, const T& z, const T& w);
     vec(const __m128& reg);
-    vec(const vec<T, 2>& other, T z = 0, T w = 0);
-    vec(const vec<T, 3>& other, T w = 0);
-    vec(const vec<T, 4>& other);
+    constexpr vec(const vec<T, 2>& other, T z = 0, T w = 0);
+    constexpr vec(const vec<T, 3>& other, T w = 0);
+    constexpr vec(const vec<T, 4>& other);
 
-    vec<T, 4>& operator=(const vec<T, 4>& other);
+    constexpr vec<T, 4>& operator=(const vec<T, 4>& other);
 
     operator T*();
     operator __m128() const;
 
-    T& operator[](size_t index);
-    const T& operator[](size_t index) const;
+    constexpr T& operator[](size_t index);
+    constexpr const T& operator[](size_t index) const;
 
     vec<T, 4>& operator+=(const vec<T, 4>& v);
     vec<T, 4>& operator-=(const vec<T, 4>& v);
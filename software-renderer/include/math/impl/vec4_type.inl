@@ -4,7 +4,7 @@
 #include <cassert>
 
 template <typename T>
-vec<T, 4>::vec(const T& value) {
+constexpr vec<T, 4>::vec(const T& value) {
     data[0] = value;
     data[1] = value;
     data[2] = value;
@@ -12,7 +12,7 @@ vec<T, 4>::vec(const T& value) {
 }
 
 template <typename T>
-vec<T, 4>::vec(const T& x, const T& y, const T& z, const T& w) {
+constexpr vec<T, 4>::vec(const T& x, const T& y, const T& z, const T& w) {
     data[0] = x;
     data[1] = y;
     data[2] = z;
@@ -25,7 +25,7 @@ vec<T, 4>::vec(const __m128& reg) {
 }
 
 template <typename T>
-vec<T, 4>::vec(const vec<T, 2>& other, T z, T w) {
+constexpr vec<T, 4>::vec(const vec<T, 2>& other, T z, T w) {
     this->data[0] = other.data[0];
     this->data[1] = other.data[1];
     this->data[2] = z;
@@ -33,7 +33,7 @@ vec<T, 4>::vec(const vec<T, 2>& other, T z, T w) {
 }
 
 template <typename T>
-vec<T, 4>::vec(const vec<T, 3>& other, T w) {
+constexpr vec<T, 4>::vec(const vec<T, 3>& other, T w) {
     this->data[0] = other.data[0];
     this->data[1] = other.data[1];
     this->data[2] = other.data[2];
@@ -41,12 +41,12 @@ vec<T, 4>::vec(const vec<T, 3>& other, T w) {
 }
 
 template <typename T>
-vec<T, 4>::vec(const vec<T, 4>& other) {
+constexpr vec<T, 4>::vec(const vec<T, 4>& other) {
     this->data = other.data;
 }
 
 template <typename T>
-vec<T, 4>& vec<T, 4>::operator=(const vec<T, 4>& other) {
+constexpr vec<T, 4>& vec<T, 4>::operator=(const vec<T, 4>& other) {
     this->data = other.data;
     return *this;
 }
@@ -62,7 +62,7 @@ vec<T, 4>::operator __m128() const {
 }
 
 template <typename T>
-T& vec<T, 4>::operator[](size_t index) {
+constexpr T& vec<T, 4>::operator[](size_t index) {
     return data[index];
 }
 
@@ -102,7 +102,7 @@ bool operator!=(const vec<T, 4>& u, const vec<T, 4>& v) {
 }
 
 template <typename T>
-const T& vec<T, 4>::operator[](size_t index) const {
+constexpr const T& vec<T, 4>::operator[](size_t index) const {
     return data[index];
 }
 
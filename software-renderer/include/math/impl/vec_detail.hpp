@@ -1,5 +1,9 @@
 #pragma once
 
+#include "../precision.hpp"
+
+#include <xmmintrin.h>
+
 namespace detail {
 
 template <typename T, bool fast>
@@ -17,11 +21,24 @@ struct computeMul {
     static T call(const T::type& s, const T& v);
 };
 
-template <typename T, bool fast>
+// 1 / x and 1 / sqrt(x) in every lane
+template <precision P>
+__m128 reciprocal(__m128 x);
+
+template <precision P>
+__m128 reciprocalSqrt(__m128 x);
+
+template <typename T, bool fast, precision P = precision::exact>
 struct computeDiv {
     static T call(const T& v, const T::type& s);
 };
 
+// a * b + c, in one rounding where the target has fma
+template <typename T, bool fast>
+struct computeFma {
+    static T call(const T& a, const T& b, const T& c);
+};
+
 template <typename T, bool fast>
 struct computeEq {
     static bool call(const T& u, const T& v);
@@ -32,11 +49,16 @@ struct computeNeq {
     static bool call(const T& u, const T& v);
 };
 
-template <typename T, bool fast>
+template <typename T, bool fast, precision P = precision::exact>
 struct computeLength {
     static T::type call(const T& v);
 };
 
+template <typename T, bool fast, precision P = precision::exact>
+struct computeNormalize {
+    static T call(const T& v);
+};
+
 template <typename T, bool fast>
 struct computeDot {
     static T::type call(const T& u, const T& v);
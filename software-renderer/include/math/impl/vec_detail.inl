@@ -1,9 +1,43 @@
 #include "vec_detail.hpp"
 
 #include <cmath>
+#include <immintrin.h>
 
 namespace detail {
 
+// lanes holding components, the padding lanes of vec2/vec3 are left out of compares and reductions
+template <typename T>
+constexpr int laneMask = (1 << T::size) - 1;
+
+template <precision P>
+inline __m128 reciprocal(__m128 x) {
+    if constexpr (P == precision::exact) {
+        return _mm_div_ps(_mm_set1_ps(1.f), x);
+    }
+
+    auto r = _mm_rcp_ps(x);
+    if constexpr (P == precision::fast) {
+        // r * (2 - x * r)
+        r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(2.f), _mm_mul_ps(x, r)));
+    }
+    return r;
+}
+
+template <precision P>
+inline __m128 reciprocalSqrt(__m128 x) {
+    if constexpr (P == precision::exact) {
+        return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(x));
+    }
+
+    auto r = _mm_rsqrt_ps(x);
+    if constexpr (P == precision::fast) {
+        // r * (1.5 - 0.5 * x * r * r)
+        auto half = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+        r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(r, r))));
+    }
+    return r;
+}
+
 template <typename T>
 struct computeAdd<T, true> {
     static T call(const T& u, const T& v) {
@@ -59,16 +93,20 @@ struct computeMul<T, false> {
     }
 };
 
-template <typename T>
-struct computeDiv<T, true> {
+template <typename T, precision P>
+struct computeDiv<T, true, P> {
     static T call(const T& v, const T::type& s) {
         auto scalar = _mm_load1_ps(&s);
-        return _mm_div_ps(v, scalar);
+        if constexpr (P == precision::exact) {
+            return _mm_div_ps(v, scalar);
+        }
+        return _mm_mul_ps(v, reciprocal<P>(scalar));
     }
 };
 
-template <typename T>
-struct computeDiv<T, false> {
+// only float has approximations, every other type is exact whatever the policy
+template <typename T, precision P>
+struct computeDiv<T, false, P> {
     static T call(const T& v, const T::type& s) {
         T res;
         for (int i = 0; i < T::size; i++) {
@@ -78,12 +116,34 @@ struct computeDiv<T, false> {
     }
 };
 
+template <typename T>
+struct computeFma<T, true> {
+    static T call(const T& a, const T& b, const T& c) {
+#ifdef __FMA__
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+};
+
+template <typename T>
+struct computeFma<T, false> {
+    static T call(const T& a, const T& b, const T& c) {
+        T res;
+        for (int i = 0; i < T::size; i++) {
+            res[i] = a[i] * b[i] + c[i];
+        }
+        return res;
+    }
+};
+
 template <typename T>
 struct computeEq<T, true> {
     static bool call(const T& u, const T& v) {
         auto eps = _mm_set1_ps(0.001f);
         auto abd = _mm_andnot_ps(_mm_set1_ps(-0.f), _mm_sub_ps(u, v));
-        return _mm_movemask_ps(_mm_cmplt_ps(abd, eps)) == 0xF;
+        return (_mm_movemask_ps(_mm_cmplt_ps(abd, eps)) & laneMask<T>) == laneMask<T>;
     }
 };
 
@@ -104,7 +164,7 @@ struct computeNeq<T, true> {
     static bool call(const T& u, const T& v) {
         auto eps = _mm_set1_ps(0.001f);
         auto abd = _mm_andnot_ps(_mm_set1_ps(-0.f), _mm_sub_ps(u, v));
-        return _mm_movemask_ps(_mm_cmplt_ps(abd, eps)) != 0xF;
+        return (_mm_movemask_ps(_mm_cmplt_ps(abd, eps)) & laneMask<T>) != laneMask<T>;
     }
 };
 
@@ -120,19 +180,22 @@ struct computeNeq<T, false> {
     }
 };
 
-template <typename T>
-struct computeLength<T, true> {
+template <typename T, precision P>
+struct computeLength<T, true, P> {
     static T::type call(const T& v) {
-        auto sq  = _mm_mul_ps(v, v);
-        auto sum = _mm_hadd_ps(sq, sq);
-        sum      = _mm_hadd_ps(sum, sum);
+        auto sum = _mm_dp_ps(v, v, (laneMask<T> << 4) | 1);
+        if constexpr (P == precision::exact) {
+            return _mm_cvtss_f32(_mm_sqrt_ss(sum));
+        }
 
-        return std::sqrt(_mm_cvtss_f32(sum));
+        // sum / sqrt(sum), masked so a zero vector stays 0 instead of 0 * inf
+        auto len = _mm_mul_ss(sum, reciprocalSqrt<P>(sum));
+        return _mm_cvtss_f32(_mm_and_ps(len, _mm_cmpneq_ss(sum, _mm_setzero_ps())));
     }
 };
 
-template <typename T>
-struct computeLength<T, false> {
+template <typename T, precision P>
+struct computeLength<T, false, P> {
     static T::type call(const T& v) {
         typename T::type sum{};
         for (int i = 0; i < T::size; i++) {
@@ -142,10 +205,32 @@ struct computeLength<T, false> {
     }
 };
 
+template <typename T, precision P>
+struct computeNormalize<T, true, P> {
+    static T call(const T& v) {
+        auto sum = _mm_dp_ps(v, v, (laneMask<T> << 4) | 0xF);
+        if constexpr (P == precision::exact) {
+            return _mm_div_ps(v, _mm_sqrt_ps(sum));
+        }
+        return _mm_mul_ps(v, reciprocalSqrt<P>(sum));
+    }
+};
+
+template <typename T, precision P>
+struct computeNormalize<T, false, P> {
+    static T call(const T& v) {
+        typename T::type sum{};
+        for (int i = 0; i < T::size; i++) {
+            sum += v[i] * v[i];
+        }
+        return v / float(std::sqrt(sum));
+    }
+};
+
 template <typename T>
 struct computeDot<T, true> {
     static T::type call(const T& u, const T& v) {
-        auto result = _mm_dp_ps(u, v, 0xFF);
+        auto result = _mm_dp_ps(u, v, (laneMask<T> << 4) | 1);
         return _mm_cvtss_f32(result);
     }
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../precision.hpp"
 #include "storage.hpp"
 
 template <typename T, size_t Size>
@@ -10,20 +11,20 @@ struct vec {
     storage<T, Size> data{};
 
     vec() = default;
-    vec(const T& value);
-    vec(const T& x, const T& y);
-    vec(const T& x, const T& y, const T& z);
-    vec(const T& x, const T& y, const T& z, const T& w);
+    constexpr vec(const T& value);
+    constexpr vec(const T& x, const T& y);
+    constexpr vec(const T& x, const T& y, const T& z);
+    constexpr vec(const T& x, const T& y, const T& z, const T& w);
     vec(const __m128& reg);
-    vec(const vec<T, Size>& other);
+    constexpr vec(const vec<T, Size>& other);
 
-    vec<T, Size>& operator=(const vec<T, Size>& other);
+    constexpr vec<T, Size>& operator=(const vec<T, Size>& other);
 
     operator T*();
     operator __m128() const;
 
-    T& operator[](size_t index);
-    const T& operator[](size_t index) const;
+    constexpr T& operator[](size_t index);
+    constexpr const T& operator[](size_t index) const;
 
     vec<T, Size>& operator+=(const vec<T, Size>& v);
     vec<T, Size>& operator-=(const vec<T, Size>& v);
@@ -47,15 +48,26 @@ struct vec {
     friend vec<V, VSize> operator/(const vec<V, VSize>& v, const float& s);
 };
 
-template <typename T, size_t Size>
+template <precision P = precision::exact, typename T, size_t Size>
 float length(const vec<T, Size>& v);
 
 template <typename T, size_t Size>
 float dot(const vec<T, Size>& u, const vec<T, Size>& v);
 
-template <typename T, size_t Size>
+template <precision P = precision::exact, typename T, size_t Size>
 vec<T, Size> normalize(const vec<T, Size>& v);
 
+// v / s at the given precision, operator/ is always exact
+template <precision P, typename T, size_t Size>
+vec<T, Size> divide(const vec<T, Size>& v, const float& s);
+
+// a * b + c per component, chains like u * a.z + v * b.z collapse into fma(v, b.z, u * a.z)
+template <typename T, size_t Size>
+vec<T, Size> fma(const vec<T, Size>& a, const vec<T, Size>& b, const vec<T, Size>& c);
+
+template <typename T, size_t Size>
+vec<T, Size> fma(const vec<T, Size>& a, const float& s, const vec<T, Size>& c);
+
 template <typename T>
 struct vec<T, 2>;
 
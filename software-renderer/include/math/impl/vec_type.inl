@@ -6,7 +6,7 @@
 #include <cassert>
 
 template <typename T, size_t Size>
-vec<T, Size>::vec(const T& value) {
+constexpr vec<T, Size>::vec(const T& value) {
     data[0] = value;
     data[1] = value;
     data[2] = value;
@@ -14,7 +14,7 @@ vec<T, Size>::vec(const T& value) {
 }
 
 template <typename T, size_t Size>
-vec<T, Size>::vec(const T& x, const T& y) {
+constexpr vec<T, Size>::vec(const T& x, const T& y) {
     static_assert(Size == 2, "Not a vector 2!");
 
     data[0] = x;
@@ -22,7 +22,7 @@ vec<T, Size>::vec(const T& x, const T& y) {
 }
 
 template <typename T, size_t Size>
-vec<T, Size>::vec(const T& x, const T& y, const T& z) {
+constexpr vec<T, Size>::vec(const T& x, const T& y, const T& z) {
     static_assert(Size == 3, "Not a vector 3!");
 
     data[0] = x;
@@ -31,7 +31,7 @@ vec<T, Size>::vec(const T& x, const T& y, const T& z) {
 }
 
 template <typename T, size_t Size>
-vec<T, Size>::vec(const T& x, const T& y, const T& z, const T& w) {
+constexpr vec<T, Size>::vec(const T& x, const T& y, const T& z, const T& w) {
     static_assert(Size == 4, "Not a vector 4!");
 
     data[0] = x;
@@ -46,12 +46,12 @@ vec<T, Size>::vec(const __m128& reg) {
 }
 
 template <typename T, size_t Size>
-vec<T, Size>::vec(const vec<T, Size>& other) {
+constexpr vec<T, Size>::vec(const vec<T, Size>& other) {
     this->data = other.data;
 }
 
 template <typename T, size_t Size>
-vec<T, Size>& vec<T, Size>::operator=(const vec<T, Size>& other) {
+constexpr vec<T, Size>& vec<T, Size>::operator=(const vec<T, Size>& other) {
     this->data = other.data;
     return *this;
 }
@@ -67,7 +67,7 @@ vec<T, Size>::operator __m128() const {
 }
 
 template <typename T, size_t Size>
-T& vec<T, Size>::operator[](size_t index) {
+constexpr T& vec<T, Size>::operator[](size_t index) {
     return data[index];
 }
 
@@ -107,7 +107,7 @@ bool operator!=(const vec<T, Size>& u, const vec<T, Size>& v) {
 }
 
 template <typename T, size_t Size>
-const T& vec<T, Size>::operator[](size_t index) const {
+constexpr const T& vec<T, Size>::operator[](size_t index) const {
     return data[index];
 }
 
@@ -136,9 +136,9 @@ vec<T, Size> operator/(const vec<T, Size>& v, const float& s) {
     return detail::computeDiv<vec<T, Size>, std::is_same<T, float>::value>::call(v, s);
 }
 
-template <typename T, size_t Size>
+template <precision P, typename T, size_t Size>
 float length(const vec<T, Size>& v) {
-    return detail::computeLength<vec<T, Size>, std::is_same<T, float>::value>::call(v);
+    return detail::computeLength<vec<T, Size>, std::is_same<T, float>::value, P>::call(v);
 }
 
 template <typename T, size_t Size>
@@ -146,8 +146,22 @@ float dot(const vec<T, Size>& u, const vec<T, Size>& v) {
     return detail::computeDot<vec<T, Size>, std::is_same<T, float>::value>::call(u, v);
 }
 
-template <typename T, size_t Size>
+template <precision P, typename T, size_t Size>
 vec<T, Size> normalize(const vec<T, Size>& v) {
-    auto len = length(v);
-    return v / len;
-}
\ No newline at end of file
+    return detail::computeNormalize<vec<T, Size>, std::is_same<T, float>::value, P>::call(v);
+}
+
+template <precision P, typename T, size_t Size>
+vec<T, Size> divide(const vec<T, Size>& v, const float& s) {
+    return detail::computeDiv<vec<T, Size>, std::is_same<T, float>::value, P>::call(v, s);
+}
+
+template <typename T, size_t Size>
+vec<T, Size> fma(const vec<T, Size>& a, const vec<T, Size>& b, const vec<T, Size>& c) {
+    return detail::computeFma<vec<T, Size>, std::is_same<T, float>::value>::call(a, b, c);
+}
+
+template <typename T, size_t Size>
+vec<T, Size> fma(const vec<T, Size>& a, const float& s, const vec<T, Size>& c) {
+    return fma(a, vec<T, Size>(s), c);
+}
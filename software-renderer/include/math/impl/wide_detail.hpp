@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <immintrin.h>
+
+namespace detail {
+
+template <size_t Lanes>
+struct wideOps;
+
+template <>
+struct wideOps<4> {
+    typedef __m128 reg;
+
+    static reg set1(float s) { return _mm_set1_ps(s); }
+    static reg zero() { return _mm_setzero_ps(); }
+    static reg load(const float* src) { return _mm_loadu_ps(src); }
+    static void store(float* dst, reg a) { _mm_storeu_ps(dst, a); }
+
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+#ifdef __FMA__
+    static reg fmadd(reg a, reg b, reg c) { return _mm_fmadd_ps(a, b, c); }
+#else
+    static reg fmadd(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+    static reg sqrt(reg a) { return _mm_sqrt_ps(a); }
+    static reg rcp(reg a) { return _mm_rcp_ps(a); }
+    static reg rsqrt(reg a) { return _mm_rsqrt_ps(a); }
+
+    static reg cmplt(reg a, reg b) { return _mm_cmplt_ps(a, b); }
+    static reg cmple(reg a, reg b) { return _mm_cmple_ps(a, b); }
+    static reg cmpeq(reg a, reg b) { return _mm_cmpeq_ps(a, b); }
+    static reg cmpneq(reg a, reg b) { return _mm_cmpneq_ps(a, b); }
+
+    static reg bitAnd(reg a, reg b) { return _mm_and_ps(a, b); }
+    static reg bitOr(reg a, reg b) { return _mm_or_ps(a, b); }
+    static reg bitXor(reg a, reg b) { return _mm_xor_ps(a, b); }
+    static reg bitAndNot(reg a, reg b) { return _mm_andnot_ps(a, b); }
+    // lanes of mask set pick a, the others b
+    static reg blend(reg mask, reg a, reg b) { return _mm_blendv_ps(b, a, mask); }
+    static int movemask(reg a) { return _mm_movemask_ps(a); }
+};
+
+#ifdef __AVX__
+template <>
+struct wideOps<8> {
+    typedef __m256 reg;
+
+    static reg set1(float s) { return _mm256_set1_ps(s); }
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg load(const float* src) { return _mm256_loadu_ps(src); }
+    static void store(float* dst, reg a) { _mm256_storeu_ps(dst, a); }
+
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+#ifdef __FMA__
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static reg sqrt(reg a) { return _mm256_sqrt_ps(a); }
+    static reg rcp(reg a) { return _mm256_rcp_ps(a); }
+    static reg rsqrt(reg a) { return _mm256_rsqrt_ps(a); }
+
+    static reg cmplt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static reg cmple(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static reg cmpeq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static reg cmpneq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+
+    static reg bitAnd(reg a, reg b) { return _mm256_and_ps(a, b); }
+    static reg bitOr(reg a, reg b) { return _mm256_or_ps(a, b); }
+    static reg bitXor(reg a, reg b) { return _mm256_xor_ps(a, b); }
+    static reg bitAndNot(reg a, reg b) { return _mm256_andnot_ps(a, b); }
+    static reg blend(reg mask, reg a, reg b) { return _mm256_blendv_ps(b, a, mask); }
+    static int movemask(reg a) { return _mm256_movemask_ps(a); }
+};
+#else
+// without AVX the 8 lanes are carried as two SSE halves
+struct m128x2 {
+    __m128 lo, hi;
+};
+
+template <>
+struct wideOps<8> {
+    typedef m128x2 reg;
+    typedef wideOps<4> half;
+
+    static reg set1(float s) { return {half::set1(s), half::set1(s)}; }
+    static reg zero() { return {half::zero(), half::zero()}; }
+    static reg load(const float* src) { return {half::load(src), half::load(src + 4)}; }
+    static void store(float* dst, reg a) {
+        half::store(dst, a.lo);
+        half::store(dst + 4, a.hi);
+    }
+
+    static reg add(reg a, reg b) { return {half::add(a.lo, b.lo), half::add(a.hi, b.hi)}; }
+    static reg sub(reg a, reg b) { return {half::sub(a.lo, b.lo), half::sub(a.hi, b.hi)}; }
+    static reg mul(reg a, reg b) { return {half::mul(a.lo, b.lo), half::mul(a.hi, b.hi)}; }
+    static reg div(reg a, reg b) { return {half::div(a.lo, b.lo), half::div(a.hi, b.hi)}; }
+    static reg fmadd(reg a, reg b, reg c) {
+        return {half::fmadd(a.lo, b.lo, c.lo), half::fmadd(a.hi, b.hi, c.hi)};
+    }
+    static reg min(reg a, reg b) { return {half::min(a.lo, b.lo), half::min(a.hi, b.hi)}; }
+    static reg max(reg a, reg b) { return {half::max(a.lo, b.lo), half::max(a.hi, b.hi)}; }
+    static reg sqrt(reg a) { return {half::sqrt(a.lo), half::sqrt(a.hi)}; }
+    static reg rcp(reg a) { return {half::rcp(a.lo), half::rcp(a.hi)}; }
+    static reg rsqrt(reg a) { return {half::rsqrt(a.lo), half::rsqrt(a.hi)}; }
+
+    static reg cmplt(reg a, reg b) { return {half::cmplt(a.lo, b.lo), half::cmplt(a.hi, b.hi)}; }
+    static reg cmple(reg a, reg b) { return {half::cmple(a.lo, b.lo), half::cmple(a.hi, b.hi)}; }
+    static reg cmpeq(reg a, reg b) { return {half::cmpeq(a.lo, b.lo), half::cmpeq(a.hi, b.hi)}; }
+    static reg cmpneq(reg a, reg b) {
+        return {half::cmpneq(a.lo, b.lo), half::cmpneq(a.hi, b.hi)};
+    }
+
+    static reg bitAnd(reg a, reg b) { return {half::bitAnd(a.lo, b.lo), half::bitAnd(a.hi, b.hi)}; }
+    static reg bitOr(reg a, reg b) { return {half::bitOr(a.lo, b.lo), half::bitOr(a.hi, b.hi)}; }
+    static reg bitXor(reg a, reg b) { return {half::bitXor(a.lo, b.lo), half::bitXor(a.hi, b.hi)}; }
+    static reg bitAndNot(reg a, reg b) {
+        return {half::bitAndNot(a.lo, b.lo), half::bitAndNot(a.hi, b.hi)};
+    }
+    static reg blend(reg mask, reg a, reg b) {
+        return {half::blend(mask.lo, a.lo, b.lo), half::blend(mask.hi, a.hi, b.hi)};
+    }
+    static int movemask(reg a) { return half::movemask(a.lo) | (half::movemask(a.hi) << 4); }
+};
+#endif
+
+};
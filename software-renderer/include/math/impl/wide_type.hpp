@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../precision.hpp"
+#include "wide_detail.hpp"
+
+#include <type_traits>
+
+// Lanes floats in one SIMD register. Comparisons return masks (every bit of a lane set) that
+// select() and the bitwise operators consume.
+template <typename T, size_t Lanes>
+struct wide {
+    static_assert(std::is_same<T, float>::value, "Only float lanes are supported!");
+
+    typedef T type;
+    typedef detail::wideOps<Lanes> ops;
+    static constexpr size_t lanes = Lanes;
+
+    typename ops::reg reg;
+
+    wide() = default;
+    wide(const T& value);
+    wide(const typename ops::reg& reg);
+
+    static wide<T, Lanes> load(const T* src);
+    void store(T* dst) const;
+
+    T operator[](size_t index) const;
+
+    wide<T, Lanes>& operator+=(const wide<T, Lanes>& v);
+    wide<T, Lanes>& operator-=(const wide<T, Lanes>& v);
+    wide<T, Lanes>& operator*=(const wide<T, Lanes>& v);
+    wide<T, Lanes>& operator/=(const wide<T, Lanes>& v);
+};
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator-(const wide<T, Lanes>& a);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator+(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator-(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator*(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator/(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator<(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator<=(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator>(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator>=(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator==(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator!=(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator&(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator|(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator^(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+
+// a * b + c, in one rounding where the target has fma
+template <typename T, size_t Lanes>
+wide<T, Lanes> fma(const wide<T, Lanes>& a, const wide<T, Lanes>& b, const wide<T, Lanes>& c);
+template <typename T, size_t Lanes>
+wide<T, Lanes> min(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> max(const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+template <typename T, size_t Lanes>
+wide<T, Lanes> abs(const wide<T, Lanes>& a);
+template <typename T, size_t Lanes>
+wide<T, Lanes> sqrt(const wide<T, Lanes>& a);
+template <precision P = precision::exact, typename T, size_t Lanes>
+wide<T, Lanes> rcp(const wide<T, Lanes>& a);
+template <precision P = precision::exact, typename T, size_t Lanes>
+wide<T, Lanes> rsqrt(const wide<T, Lanes>& a);
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> select(const wide<T, Lanes>& mask, const wide<T, Lanes>& a, const wide<T, Lanes>& b);
+// one bit per lane, lane 0 in bit 0
+template <typename T, size_t Lanes>
+int bitmask(const wide<T, Lanes>& mask);
+template <typename T, size_t Lanes>
+bool any(const wide<T, Lanes>& mask);
+template <typename T, size_t Lanes>
+bool all(const wide<T, Lanes>& mask);
+
+#include "wide_type.inl"
@@ -0,0 +1,197 @@
+#include "wide_type.hpp"
+
+#include <cassert>
+
+template <typename T, size_t Lanes>
+wide<T, Lanes>::wide(const T& value) {
+    reg = ops::set1(value);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes>::wide(const typename ops::reg& reg) {
+    this->reg = reg;
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> wide<T, Lanes>::load(const T* src) {
+    return ops::load(src);
+}
+
+template <typename T, size_t Lanes>
+void wide<T, Lanes>::store(T* dst) const {
+    ops::store(dst, reg);
+}
+
+template <typename T, size_t Lanes>
+T wide<T, Lanes>::operator[](size_t index) const {
+    assert(index < Lanes);
+
+    T buffer[Lanes];
+    ops::store(buffer, reg);
+    return buffer[index];
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes>& wide<T, Lanes>::operator+=(const wide<T, Lanes>& v) {
+    *this = *this + v;
+    return *this;
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes>& wide<T, Lanes>::operator-=(const wide<T, Lanes>& v) {
+    *this = *this - v;
+    return *this;
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes>& wide<T, Lanes>::operator*=(const wide<T, Lanes>& v) {
+    *this = *this * v;
+    return *this;
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes>& wide<T, Lanes>::operator/=(const wide<T, Lanes>& v) {
+    *this = *this / v;
+    return *this;
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator-(const wide<T, Lanes>& a) {
+    return wide<T, Lanes>::ops::bitXor(a.reg, wide<T, Lanes>::ops::set1(-0.f));
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator+(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::add(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator-(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::sub(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator*(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::mul(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator/(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::div(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator<(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::cmplt(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator<=(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::cmple(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator>(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::cmplt(b.reg, a.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator>=(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::cmple(b.reg, a.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator==(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::cmpeq(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator!=(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::cmpneq(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator&(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::bitAnd(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator|(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::bitOr(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> operator^(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::bitXor(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> fma(const wide<T, Lanes>& a, const wide<T, Lanes>& b, const wide<T, Lanes>& c) {
+    return wide<T, Lanes>::ops::fmadd(a.reg, b.reg, c.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> min(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::min(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> max(const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::max(a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> abs(const wide<T, Lanes>& a) {
+    return wide<T, Lanes>::ops::bitAndNot(wide<T, Lanes>::ops::set1(-0.f), a.reg);
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> sqrt(const wide<T, Lanes>& a) {
+    return wide<T, Lanes>::ops::sqrt(a.reg);
+}
+
+template <precision P, typename T, size_t Lanes>
+wide<T, Lanes> rcp(const wide<T, Lanes>& a) {
+    if constexpr (P == precision::exact) {
+        return wide<T, Lanes>(1.f) / a;
+    }
+
+    wide<T, Lanes> r = wide<T, Lanes>::ops::rcp(a.reg);
+    if constexpr (P == precision::fast) {
+        r = r * (wide<T, Lanes>(2.f) - a * r);
+    }
+    return r;
+}
+
+template <precision P, typename T, size_t Lanes>
+wide<T, Lanes> rsqrt(const wide<T, Lanes>& a) {
+    if constexpr (P == precision::exact) {
+        return wide<T, Lanes>(1.f) / sqrt(a);
+    }
+
+    wide<T, Lanes> r = wide<T, Lanes>::ops::rsqrt(a.reg);
+    if constexpr (P == precision::fast) {
+        r = r * (wide<T, Lanes>(1.5f) - wide<T, Lanes>(0.5f) * a * r * r);
+    }
+    return r;
+}
+
+template <typename T, size_t Lanes>
+wide<T, Lanes> select(const wide<T, Lanes>& mask, const wide<T, Lanes>& a, const wide<T, Lanes>& b) {
+    return wide<T, Lanes>::ops::blend(mask.reg, a.reg, b.reg);
+}
+
+template <typename T, size_t Lanes>
+int bitmask(const wide<T, Lanes>& mask) {
+    return wide<T, Lanes>::ops::movemask(mask.reg);
+}
+
+template <typename T, size_t Lanes>
+bool any(const wide<T, Lanes>& mask) {
+    return bitmask(mask) != 0;
+}
+
+template <typename T, size_t Lanes>
+bool all(const wide<T, Lanes>& mask) {
+    return bitmask(mask) == (1 << Lanes) - 1;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "wide_type.hpp"
+
+template <typename T, size_t Size>
+struct vec;
+
+template <typename T, size_t Size>
+struct mat;
+
+template <typename W, size_t Size>
+struct wide_storage;
+
+template <typename W>
+struct wide_storage<W, 2> {
+    union {
+        W data[2];
+        struct {
+            W x, y;
+        };
+    };
+};
+
+template <typename W>
+struct wide_storage<W, 3> {
+    union {
+        W data[3];
+        struct {
+            W x, y, z;
+        };
+    };
+};
+
+template <typename W>
+struct wide_storage<W, 4> {
+    union {
+        W data[4];
+        struct {
+            W x, y, z, w;
+        };
+    };
+};
+
+// Lanes vectors in structure of arrays form, one register per component. Batches are filled from
+// and written back to the regular array of structures vec buffers with load() and store().
+template <typename T, size_t Size, size_t Lanes>
+struct wide_vec : wide_storage<wide<T, Lanes>, Size> {
+    typedef wide<T, Lanes> component;
+    static constexpr size_t size  = Size;
+    static constexpr size_t lanes = Lanes;
+
+    wide_vec() = default;
+    wide_vec(const component& value);
+    wide_vec(const vec<T, Size>& value);
+    wide_vec(const component& x, const component& y);
+    wide_vec(const component& x, const component& y, const component& z);
+    wide_vec(const component& x, const component& y, const component& z, const component& w);
+    // drops trailing components or fills the missing ones with fill
+    template <size_t OtherSize>
+    explicit wide_vec(const wide_vec<T, OtherSize, Lanes>& other, const component& fill = T(0));
+
+    // lanes past count are zero
+    static wide_vec<T, Size, Lanes> load(const vec<T, Size>* src, size_t count = Lanes);
+    void store(vec<T, Size>* dst, size_t count = Lanes) const;
+
+    component& operator[](size_t index);
+    const component& operator[](size_t index) const;
+    vec<T, Size> lane(size_t index) const;
+
+    wide_vec<T, Size, Lanes>& operator+=(const wide_vec<T, Size, Lanes>& v);
+    wide_vec<T, Size, Lanes>& operator-=(const wide_vec<T, Size, Lanes>& v);
+    wide_vec<T, Size, Lanes>& operator*=(const component& s);
+    wide_vec<T, Size, Lanes>& operator/=(const component& s);
+};
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator-(const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator+(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator-(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const wide<T, Lanes>& s, const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const wide_vec<T, Size, Lanes>& v, const wide<T, Lanes>& s);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator/(const wide_vec<T, Size, Lanes>& v, const wide<T, Lanes>& s);
+
+template <typename T, size_t Size, size_t Lanes>
+wide<T, Lanes> dot(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v);
+// a * s + c per component
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> fma(
+        const wide_vec<T, Size, Lanes>& a,
+        const wide<T, Lanes>& s,
+        const wide_vec<T, Size, Lanes>& c
+);
+template <typename T, size_t Lanes>
+wide_vec<T, 3, Lanes> cross(const wide_vec<T, 3, Lanes>& u, const wide_vec<T, 3, Lanes>& v);
+template <precision P = precision::exact, typename T, size_t Size, size_t Lanes>
+wide<T, Lanes> length(const wide_vec<T, Size, Lanes>& v);
+template <precision P = precision::exact, typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> normalize(const wide_vec<T, Size, Lanes>& v);
+// v / s at the given precision, operator/ is always exact
+template <precision P, typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> divide(const wide_vec<T, Size, Lanes>& v, const wide<T, Lanes>& s);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> min(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> max(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v);
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> select(
+        const wide<T, Lanes>& mask,
+        const wide_vec<T, Size, Lanes>& u,
+        const wide_vec<T, Size, Lanes>& v
+);
+
+// the same matrix applied to every lane
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const mat<T, Size>& m, const wide_vec<T, Size, Lanes>& v);
+
+#include "wide_vec_type.inl"
@@ -0,0 +1,297 @@
+#include "wide_vec_type.hpp"
+
+#include <cassert>
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>::wide_vec(const component& value) {
+    for (size_t i = 0; i < Size; i++) {
+        this->data[i] = value;
+    }
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>::wide_vec(const vec<T, Size>& value) {
+    for (size_t i = 0; i < Size; i++) {
+        this->data[i] = value[i];
+    }
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>::wide_vec(const component& x, const component& y) {
+    static_assert(Size == 2, "Not a vector 2!");
+
+    this->data[0] = x;
+    this->data[1] = y;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>::wide_vec(const component& x, const component& y, const component& z) {
+    static_assert(Size == 3, "Not a vector 3!");
+
+    this->data[0] = x;
+    this->data[1] = y;
+    this->data[2] = z;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>::wide_vec(
+        const component& x,
+        const component& y,
+        const component& z,
+        const component& w
+) {
+    static_assert(Size == 4, "Not a vector 4!");
+
+    this->data[0] = x;
+    this->data[1] = y;
+    this->data[2] = z;
+    this->data[3] = w;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+template <size_t OtherSize>
+wide_vec<T, Size, Lanes>::wide_vec(const wide_vec<T, OtherSize, Lanes>& other, const component& fill) {
+    for (size_t i = 0; i < Size; i++) {
+        this->data[i] = i < OtherSize ? other.data[i] : fill;
+    }
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> wide_vec<T, Size, Lanes>::load(const vec<T, Size>* src, size_t count) {
+    assert(count <= Lanes);
+
+    alignas(32) T lanes[Size][Lanes]{};
+    for (size_t i = 0; i < count; i++) {
+        for (size_t c = 0; c < Size; c++) {
+            lanes[c][i] = src[i][c];
+        }
+    }
+
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = component::load(lanes[c]);
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+void wide_vec<T, Size, Lanes>::store(vec<T, Size>* dst, size_t count) const {
+    assert(count <= Lanes);
+
+    alignas(32) T lanes[Size][Lanes];
+    for (size_t c = 0; c < Size; c++) {
+        this->data[c].store(lanes[c]);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        for (size_t c = 0; c < Size; c++) {
+            dst[i][c] = lanes[c][i];
+        }
+    }
+}
+
+template <typename T, size_t Size, size_t Lanes>
+typename wide_vec<T, Size, Lanes>::component& wide_vec<T, Size, Lanes>::operator[](size_t index) {
+    assert(index < Size);
+    return this->data[index];
+}
+
+template <typename T, size_t Size, size_t Lanes>
+const typename wide_vec<T, Size, Lanes>::component& wide_vec<T, Size, Lanes>::operator[](size_t index) const {
+    assert(index < Size);
+    return this->data[index];
+}
+
+template <typename T, size_t Size, size_t Lanes>
+vec<T, Size> wide_vec<T, Size, Lanes>::lane(size_t index) const {
+    vec<T, Size> result;
+    for (size_t c = 0; c < Size; c++) {
+        result[c] = this->data[c][index];
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>& wide_vec<T, Size, Lanes>::operator+=(const wide_vec<T, Size, Lanes>& v) {
+    *this = *this + v;
+    return *this;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>& wide_vec<T, Size, Lanes>::operator-=(const wide_vec<T, Size, Lanes>& v) {
+    *this = *this - v;
+    return *this;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>& wide_vec<T, Size, Lanes>::operator*=(const component& s) {
+    *this = *this * s;
+    return *this;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes>& wide_vec<T, Size, Lanes>::operator/=(const component& s) {
+    *this = *this / s;
+    return *this;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator-(const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = -v.data[c];
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator+(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = u.data[c] + v.data[c];
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator-(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = u.data[c] - v.data[c];
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = u.data[c] * v.data[c];
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const wide<T, Lanes>& s, const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = s * v.data[c];
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const wide_vec<T, Size, Lanes>& v, const wide<T, Lanes>& s) {
+    return s * v;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator/(const wide_vec<T, Size, Lanes>& v, const wide<T, Lanes>& s) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = v.data[c] / s;
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide<T, Lanes> dot(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v) {
+    auto result = u.data[0] * v.data[0];
+    for (size_t c = 1; c < Size; c++) {
+        result = fma(u.data[c], v.data[c], result);
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> fma(
+        const wide_vec<T, Size, Lanes>& a,
+        const wide<T, Lanes>& s,
+        const wide_vec<T, Size, Lanes>& c
+) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t i = 0; i < Size; i++) {
+        result.data[i] = fma(a.data[i], s, c.data[i]);
+    }
+    return result;
+}
+
+template <typename T, size_t Lanes>
+wide_vec<T, 3, Lanes> cross(const wide_vec<T, 3, Lanes>& u, const wide_vec<T, 3, Lanes>& v) {
+    return wide_vec<T, 3, Lanes>(
+            u.y * v.z - u.z * v.y,
+            u.z * v.x - u.x * v.z,
+            u.x * v.y - u.y * v.x
+    );
+}
+
+template <precision P, typename T, size_t Size, size_t Lanes>
+wide<T, Lanes> length(const wide_vec<T, Size, Lanes>& v) {
+    auto sum = dot(v, v);
+    if constexpr (P == precision::exact) {
+        return sqrt(sum);
+    }
+    // masked so zero vectors stay 0 instead of 0 * inf
+    return (sum * rsqrt<P>(sum)) & (sum != wide<T, Lanes>(0.f));
+}
+
+template <precision P, typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> normalize(const wide_vec<T, Size, Lanes>& v) {
+    if constexpr (P == precision::exact) {
+        return v / length(v);
+    }
+    return v * rsqrt<P>(dot(v, v));
+}
+
+template <precision P, typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> divide(const wide_vec<T, Size, Lanes>& v, const wide<T, Lanes>& s) {
+    if constexpr (P == precision::exact) {
+        return v / s;
+    }
+    return v * rcp<P>(s);
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> min(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = min(u.data[c], v.data[c]);
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> max(const wide_vec<T, Size, Lanes>& u, const wide_vec<T, Size, Lanes>& v) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = max(u.data[c], v.data[c]);
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> select(
+        const wide<T, Lanes>& mask,
+        const wide_vec<T, Size, Lanes>& u,
+        const wide_vec<T, Size, Lanes>& v
+) {
+    wide_vec<T, Size, Lanes> result;
+    for (size_t c = 0; c < Size; c++) {
+        result.data[c] = select(mask, u.data[c], v.data[c]);
+    }
+    return result;
+}
+
+template <typename T, size_t Size, size_t Lanes>
+wide_vec<T, Size, Lanes> operator*(const mat<T, Size>& m, const wide_vec<T, Size, Lanes>& v) {
+    // columns are stored contiguously, row r sums column c's r-th entry times component c
+    wide_vec<T, Size, Lanes> result;
+    for (size_t r = 0; r < Size; r++) {
+        auto sum = wide<T, Lanes>(m[0][r]) * v.data[0];
+        for (size_t c = 1; c < Size; c++) {
+            sum = fma(wide<T, Lanes>(m[c][r]), v.data[c], sum);
+        }
+        result.data[r] = sum;
+    }
+    return result;
+}
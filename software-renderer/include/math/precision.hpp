@@ -0,0 +1,15 @@
+#pragma once
+
+// How much accuracy a call site gives up for speed in reciprocals and square roots, picked per
+// call through the template argument of normalize, length, divide, rcp and rsqrt.
+//
+//  exact        divps and sqrtps, correctly rounded.
+//  fast         rcpps or rsqrtps refined by one Newton-Raphson step, relative error below 2^-21.
+//  approximate  rcpps or rsqrtps alone, relative error below 1.5 * 2^-12.
+//
+// The bounds are the ones test/vec_test.cpp and test/wide_test.cpp check.
+enum class precision {
+    exact,
+    fast,
+    approximate
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "impl/quat_type.hpp"
+#include "impl/dual_quat_type.hpp"
+
+using quat     = quaternion<float>;
+using dualquat = dual_quaternion<float>;
@@ -1,51 +1,87 @@
 #pragma once
 
 #include "mat.hpp"
+#include "quat.hpp"
 #include "vec.hpp"
 
-inline mat4 translate(const vec3& translate) {
+#include <cmath>
+
+constexpr mat4 translate(const vec3& translate) {
     auto ret  = mat4(1.f);
-    ret[3][0] = translate.x;
-    ret[3][1] = translate.y;
-    ret[3][2] = translate.z;
+    ret[3][0] = translate[0];
+    ret[3][1] = translate[1];
+    ret[3][2] = translate[2];
     return ret;
 }
 
-inline mat4 scale(const vec3& scale) {
+constexpr mat4 scale(const vec3& scale) {
     auto ret  = mat4(1.f);
-    ret[0][0] = scale.x;
-    ret[1][1] = scale.y;
-    ret[2][2] = scale.z;
+    ret[0][0] = scale[0];
+    ret[1][1] = scale[1];
+    ret[2][2] = scale[2];
     return ret;
 }
 
+// the rotations and perspective are not constexpr, std::sin, cos and tan are not before C++26
 inline mat4 rotateOX(float angle) {
-    auto rad  = angle * (M_PI / 180);
+    auto rad  = angle * float(M_PI / 180);
+    auto c    = std::cos(rad);
+    auto s    = std::sin(rad);
     auto ret  = mat4(1.f);
-    ret[1][1] = cos(rad);
-    ret[1][2] = sin(rad);
-    ret[2][1] = -sin(rad);
-    ret[2][2] = cos(rad);
+    ret[1][1] = c;
+    ret[1][2] = s;
+    ret[2][1] = -s;
+    ret[2][2] = c;
     return ret;
 }
 
 inline mat4 rotateOY(float angle) {
-    auto rad  = angle * (M_PI / 180);
+    auto rad  = angle * float(M_PI / 180);
+    auto c    = std::cos(rad);
+    auto s    = std::sin(rad);
     auto ret  = mat4(1.f);
-    ret[0][0] = cos(rad);
-    ret[0][2] = -sin(rad);
-    ret[2][0] = sin(rad);
-    ret[2][2] = cos(rad);
+    ret[0][0] = c;
+    ret[0][2] = -s;
+    ret[2][0] = s;
+    ret[2][2] = c;
     return ret;
 }
 
 inline mat4 rotateOZ(float angle) {
-    auto rad  = angle * (M_PI / 180);
+    auto rad  = angle * float(M_PI / 180);
+    auto c    = std::cos(rad);
+    auto s    = std::sin(rad);
     auto ret  = mat4(1.f);
-    ret[0][0] = cos(rad);
-    ret[0][1] = sin(rad);
-    ret[1][0] = -sin(rad);
-    ret[1][1] = cos(rad);
+    ret[0][0] = c;
+    ret[0][1] = s;
+    ret[1][0] = -s;
+    ret[1][1] = c;
+    return ret;
+}
+
+// the matrix of the unit quaternion q, the same rotation rotateOX builds for angleAxis(angle, x)
+inline mat4 rotate(const quat& q) {
+    auto x = q.x, y = q.y, z = q.z, w = q.w;
+    auto ret  = mat4(1.f);
+    ret[0][0] = 1.f - 2.f * (y * y + z * z);
+    ret[0][1] = 2.f * (x * y + w * z);
+    ret[0][2] = 2.f * (x * z - w * y);
+    ret[1][0] = 2.f * (x * y - w * z);
+    ret[1][1] = 1.f - 2.f * (x * x + z * z);
+    ret[1][2] = 2.f * (y * z + w * x);
+    ret[2][0] = 2.f * (x * z + w * y);
+    ret[2][1] = 2.f * (y * z - w * x);
+    ret[2][2] = 1.f - 2.f * (x * x + y * y);
+    return ret;
+}
+
+// translate(translation(dq)) * rotate(dq.real) for a normalized dq
+inline mat4 rotateTranslate(const dualquat& dq) {
+    auto ret = rotate(dq.real);
+    auto t   = translation(dq);
+    ret[3][0] = t.x;
+    ret[3][1] = t.y;
+    ret[3][2] = t.z;
     return ret;
 }
 
@@ -62,21 +98,19 @@ inline mat4 perspective(float fovy, float aspect, float zNear, float zFar) {
     return mat;
 }
 
-inline mat4 view(const vec3& position, const vec3& forward, const vec3& right, const vec3& up) {
-    auto mat  = mat4(1.f);
-    mat[0][0] = right.x;
-    mat[1][0] = right.y;
-    mat[2][0] = right.z;
-
-    mat[0][1] = up.x;
-    mat[1][1] = up.y;
-    mat[2][1] = up.z;
-
-    mat[0][2] = forward.x;
-    mat[1][2] = forward.y;
-    mat[2][2] = forward.z;
-
-    return mat * translate(-1 * position);
+constexpr mat4 view(const vec3& position, const vec3& forward, const vec3& right, const vec3& up) {
+    auto mat = mat4(1.f);
+    for (int i = 0; i < 3; i++) {
+        mat[i][0] = right[i];
+        mat[i][1] = up[i];
+        mat[i][2] = forward[i];
+    }
+
+    // the rotation applied to the translation by -position, without a full matrix product
+    for (int row = 0; row < 3; row++) {
+        mat[3][row] = -(mat[0][row] * position[0] + mat[1][row] * position[1] + mat[2][row] * position[2]);
+    }
+    return mat;
 }
 
 struct logic_space {
@@ -87,7 +121,7 @@ struct viewport_space {
     float x, y, width, height;
 };
 
-inline mat4 viewport(const logic_space& logicSpace, const viewport_space& viewportSpace) {
+constexpr mat4 viewport(const logic_space& logicSpace, const viewport_space& viewportSpace) {
     auto originTranslate = translate({-logicSpace.x, -logicSpace.y, 0.0f});
     auto viewTranslate   = translate({viewportSpace.x, viewportSpace.y, 0.0f});
     auto viewScale =
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "vec.hpp"
+#include "mat.hpp"
+#include "impl/wide_vec_type.hpp"
+
+using floatx4 = wide<float, 4>;
+using floatx8 = wide<float, 8>;
+
+using vec2x4 = wide_vec<float, 2, 4>;
+using vec3x4 = wide_vec<float, 3, 4>;
+using vec4x4 = wide_vec<float, 4, 4>;
+
+using vec2x8 = wide_vec<float, 2, 8>;
+using vec3x8 = wide_vec<float, 3, 8>;
+using vec4x8 = wide_vec<float, 4, 8>;
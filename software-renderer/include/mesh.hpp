@@ -3,6 +3,7 @@
 #include "types.hpp"
 #include "math/vec.hpp"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,11 @@ namespace sfr::mesh {
 struct mesh_data {
     std::vector<u32> indices;
     std::vector<vec3> vertices;
+
+    // Skin weights, one entry per vertex or none for a rigid mesh. Up to 4 joints into the pose
+    // palette each, with weights summing to 1, unused slots weighted 0.
+    std::vector<std::array<u16, 4>> joints;
+    std::vector<vec4> weights;
 };
 
 mesh_data loadFromFile(const std::string& path);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "types.hpp"
+#include "texture.hpp"
+
+namespace sfr::msaa {
+
+constexpr int MaxSamples = 8;
+
+// Multisampled color and depth, stored as one plane per sample. A pixel flagged as uniform has
+// all of its samples equal to plane 0 and the other planes are stale, so interior pixels only
+// ever touch plane 0. Uniform pixels keep the depth at the pixel center for every sample.
+struct msaa_data {
+    int samples;
+    texture::pixel_format format;
+
+    size_t width;
+    size_t height;
+    size_t stride;
+    u32* colors;
+    float* depths;
+    u8* uniform;
+};
+
+msaa_data create(size_t width, size_t height, int samples, texture::pixel_format format);
+void destroy(msaa_data& msaa);
+
+// Only writes plane 0 and the flags.
+void clear(msaa_data& msaa, const color& col, float depth = 1.f);
+// The pixels of area, rounded out to whole quads like texture::clear.
+void clear(msaa_data& msaa, const color& col, const texture::rect& area, float depth = 1.f);
+
+// Sample offsets from the pixel center, the standard 4x and 8x patterns.
+const vec2* samplePositions(int samples);
+
+// Makes the pixel at idx hold its own value in every plane.
+void expand(msaa_data& msaa, size_t idx);
+
+// Averages the samples of every pixel into out, which must share the format and size.
+void resolve(const msaa_data& msaa, texture::texture_data& out);
+// Only the quads overlapping area.
+void resolve(const msaa_data& msaa, texture::texture_data& out, const texture::rect& area);
+
+};// namespace sfr::msaa
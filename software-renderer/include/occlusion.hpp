@@ -0,0 +1,47 @@
+#pragma once
+
+#include "types.hpp"
+#include "math/vec.hpp"
+
+#include <vector>
+
+namespace sfr::occlusion {
+
+// screen pixels per side of a buffer pixel
+constexpr int Scale = 4;
+// buffer pixels per side of a block of the coarse level
+constexpr int BlockSize = 8;
+
+// What a handful of occluders hide, at 1/Scale of the screen resolution. A buffer pixel holds the
+// farthest depth of occluders covering all of it, 1 when none do, so anything behind that depth is
+// hidden there. Triangles only covering part of it add their screen pixel centers to a coverage
+// mask and their depth to a layer, which the pixel takes once the mask is full, so adjacent
+// triangles of an occluder hide what is behind their shared edges. Rows are padded to whole quads.
+struct buffer_data {
+    int width, height;
+    int stride;
+    std::vector<float> depths;
+    std::vector<u16> masks;
+    std::vector<float> layers;
+
+    // the farthest depth of every block of BlockSize x BlockSize buffer pixels
+    int blocksX, blocksY;
+    int blockStride;
+    std::vector<float> blocks;
+};
+
+buffer_data create(size_t screenWidth, size_t screenHeight);
+// Nothing occludes anything until occluders are added again.
+void clear(buffer_data& buffer);
+
+// Rasterizes the indexed triangles of screen space vertices at the farthest depth they have over
+// each buffer pixel, so the buffer never hides too much.
+void addOccluders(buffer_data& buffer, const std::vector<vec3>& vertices, const std::vector<u32>& indices);
+// Builds the coarse level, once every occluder was added and before the first test.
+void finish(buffer_data& buffer);
+
+// False when everything inside the screen space box lo to hi is hidden by the occluders or off
+// screen, lo.z being its nearest depth. Large boxes are tested against the coarse level.
+bool visible(const buffer_data& buffer, const vec3& lo, const vec3& hi);
+
+};// namespace sfr::occlusion
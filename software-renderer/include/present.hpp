@@ -0,0 +1,76 @@
+#pragma once
+
+#include "types.hpp"
+#include "texture.hpp"
+
+#include <string>
+
+namespace sfr::present {
+
+// Hooks a presentation target exposes to the present thread. attach/detach run once on the
+// present thread (e.g. to make a GL context current there), present runs once per frame.
+struct backend {
+    void* user;
+    // Optional memory holding every buffer back to back (e.g. a persistently mapped upload
+    // buffer), so frames are rendered straight into it. Buffers are heap allocated when null.
+    void* storage;
+
+    void (*attach)(void* user);
+    void (*detach)(void* user);
+    void (*present)(void* user, const texture::texture_data& frame);
+    // Optional, blocks until a presented frame's memory may be rendered into again (e.g. waits on
+    // the fence of its upload). Runs on the present thread, and only once the renderer is out of
+    // buffers and waiting for that one, so uploads overlap with rendering in the meantime.
+    void (*reclaim)(void* user, const texture::texture_data& frame) = nullptr;
+};
+
+constexpr int MaxBuffers = 3;
+
+struct present_queue;
+
+// Swap chain of color targets handed off to a dedicated present thread, so the renderer can
+// rasterize frame N+1 while frame N is being uploaded and swapped.
+struct present_data {
+    backend sink;
+
+    int bufferCount;
+    texture::pixel_format format;
+    size_t width;
+    size_t height;
+    present_queue* queue;
+};
+
+present_data create(
+        const backend& backend,
+        size_t width,
+        size_t height,
+        int bufferCount              = 2,
+        texture::pixel_format format = texture::BGRA8
+);
+void destroy(present_data& present);
+
+// Blocks until one of the buffers is no longer in flight and returns it for rendering.
+texture::texture_data& acquire(present_data& present);
+// Queues the acquired buffer for presentation and returns immediately.
+void submit(present_data& present);
+// Blocks until every submitted frame has been presented.
+void flush(present_data& present);
+
+struct null_target {
+    u64 frames;
+    u64 checksum;
+    u32 delayMicros;
+};
+
+struct file_target {
+    std::string prefix;
+    u64 frames;
+};
+
+// Discards frames, only folding them into a running checksum. delayMicros simulates the cost
+// of a real hand-off, which lets the pipelining be exercised without a GPU.
+backend nullBackend(null_target& target);
+// Writes every frame as <prefix><frame>.ppm, converted to RGB8.
+backend fileBackend(file_target& target);
+
+};// namespace sfr::present
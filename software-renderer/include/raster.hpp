@@ -0,0 +1,182 @@
+#pragma once
+
+#include "types.hpp"
+#include "texture.hpp"
+#include "msaa.hpp"
+#include "kernels.hpp"
+#include "math/vec.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace sfr::raster {
+
+// Surfaces a draw writes to. With msaa set, coverage and depth are tracked per sample in it
+// and color/depth are left alone until the msaa storage is resolved. Pixels outside scissor are
+// never touched.
+struct target_data {
+    texture::texture_data* color;
+    texture::texture_data* depth;
+    msaa::msaa_data* msaa;
+    texture::rect scissor = {0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+};
+
+// Triangles set up once for every pass and tile drawing them, field by field. Edge i of edges[t]
+// is a * x + b * y + c, positive on the inside and weighting vertex i, index[t] is the triangle's
+// position in the index buffer. A tile only streams through the boxes of the triangles it misses,
+// those are padded to whole quads with empty ones.
+struct triangle_buffer {
+    std::vector<int> minX, minY;
+    std::vector<int> maxX, maxY;
+    std::vector<kernels::triangle_edges> edges;
+    std::vector<u32> index;
+
+    // With binRows set, the triangles reaching band b of that many rows from y = 0 are
+    // binned[binStarts[b]] up to binned[binStarts[b + 1]], in buffer order.
+    int binRows = 0;
+    std::vector<u32> binStarts;
+    std::vector<u32> binned;
+};
+
+// Triangles whose box holds at least LargeTriangle pixels are walked in BlockSize x BlockSize
+// blocks, skipping the ones outside and filling fully covered ones without edge tests. Smaller
+// ones go row by row over their whole box. Either way the same pixels get the same depths.
+constexpr int BlockSize     = 8;
+constexpr int LargeTriangle = 1024;
+
+// Sets up the indexed triangles of screen space vertices in parallel over ranges of them, dropping
+// degenerate ones and those entirely outside bounds. Triangles keep their order.
+triangle_buffer setupTriangles(
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+);
+// The same into triangles, unbinned, reusing the storage it already has so a buffer set up every
+// frame stops allocating once it is as large as it gets. Scratch comes from the thread's arena
+// and is given back before returning.
+void setupTriangles(
+        triangle_buffer& triangles,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+);
+
+// Sorts the triangles into bands of rows down to height, for tiles of one band each to only look at
+// their own. Ranges of triangles are binned in parallel, each into slots of its own, so there are
+// no shared bins to contend over and the result does not depend on the number of workers. The
+// bins reuse their storage, the counts come from the thread's arena for the call only.
+void binTriangles(triangle_buffer& triangles, int rows, int height);
+
+// Fills the indexed triangles of screen space vertices, triangle i taking colors[i % size].
+void drawTriangles(
+        target_data& target,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const std::vector<color>& colors
+);
+
+// The same for triangles already set up, through their bin when the target's bounds lie in one
+// band. With equalDepth a pixel is only written by the triangles whose depth it holds, after
+// drawDepth that shades every visible pixel once. equalDepth needs a single sample target of a
+// packed format, filled by the same kernels drawDepth runs.
+void drawTriangles(
+        target_data& target,
+        const triangle_buffer& triangles,
+        const std::vector<color>& colors,
+        bool equalDepth = false
+);
+
+// Depth-only pre-pass: keeps the nearest depth of the triangles in target.depth, color untouched.
+// Single sample targets only.
+void drawDepth(target_data& target, const triangle_buffer& triangles);
+
+// A piece of a segment set up once for every tile drawing it. Its pixels are the ones holding
+// start + i * step for first <= i <= last, one per step along the longer axis, so tiles split it
+// without gaps or overlaps.
+struct line_setup {
+    vec3 start;
+    vec3 step;
+    int first, last;
+    // pixels the clipped segment reaches, tiles holding all of it skip the clipping
+    texture::rect area;
+    u32 index;
+};
+
+// Sets up the segments between pairs of indexed screen space vertices, clipped to bounds in
+// parallel over ranges of them. Segments are cut into pieces of at most LineChunk steps and sorted
+// by the first row they reach, so a tile only looks at the pieces near its rows.
+constexpr int LineChunk = 64;
+std::vector<line_setup> setupLines(
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+);
+// The same into lines, reusing what it already holds.
+void setupLines(
+        std::vector<line_setup>& lines,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+);
+// Every edge of the indexed triangles once, as index pairs for setupLines.
+std::vector<u32> wireframeEdges(const std::vector<u32>& indices);
+
+// Overlays go on top of a finished frame: segment i takes colors[i % size], and with depthTest
+// only pixels no farther than target.depth (give or take LineDepthBias, so wireframes stay on top
+// of their own surfaces) are written. Depth is never written. Color and depth textures only, the
+// msaa storage is resolved by then.
+constexpr float LineDepthBias = 1e-4f;
+// lines as setupLines sorted them.
+void drawLines(
+        target_data& target,
+        const std::vector<line_setup>& lines,
+        const std::vector<color>& colors,
+        bool depthTest = true
+);
+void drawLines(
+        target_data& target,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const std::vector<color>& colors,
+        bool depthTest = true
+);
+// A point set up once for every tile drawing it: the pixels it covers, clipped, at one depth.
+struct point_setup {
+    texture::rect area;
+    float depth;
+    u32 index;
+};
+
+// Sets up squares of size pixels around each vertex, clipped to bounds, in parallel over ranges
+// of them. They are sorted by the rows they cover, so a tile only looks at the ones reaching its
+// own.
+std::vector<point_setup> setupPoints(
+        const std::vector<vec3>& vertices,
+        const texture::rect& bounds,
+        int size = 1
+);
+// The same into points, reusing what it already holds.
+void setupPoints(
+        std::vector<point_setup>& points,
+        const std::vector<vec3>& vertices,
+        const texture::rect& bounds,
+        int size = 1
+);
+
+// points as setupPoints sorted them, point i taking colors[i % size].
+void drawPoints(
+        target_data& target,
+        const std::vector<point_setup>& points,
+        const std::vector<color>& colors,
+        bool depthTest = true
+);
+// Squares of size pixels around each vertex, point i taking colors[i % size].
+void drawPoints(
+        target_data& target,
+        const std::vector<vec3>& vertices,
+        const std::vector<color>& colors,
+        int size       = 1,
+        bool depthTest = true
+);
+
+};// namespace sfr::raster
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "types.hpp"
+#include "texture.hpp"
+#include "msaa.hpp"
+#include "raster.hpp"
+#include "math/mat.hpp"
+#include "math/vec.hpp"
+
+#include <vector>
+
+namespace sfr::shadow {
+
+constexpr int MaxCascades = 4;
+
+// Depth of the casters seen from the light over one slice of the camera frustum. Map depth is 0
+// nearest the light and 1 at the farthest caster or receiver of the slice.
+struct cascade_data {
+    texture::texture_data depth;
+    mat4 worldToMap;
+    // screen depth the slice ends at, pixels up to it use this cascade
+    float splitDepth;
+
+    // the casters in map space and set up, kept from render to render so they stop growing
+    std::vector<vec3> vertices;
+    raster::triangle_buffer triangles;
+};
+
+// A directional light and its cascaded shadow maps.
+struct shadow_data {
+    // the way the light travels
+    vec3 direction;
+    // added to the depth of every caster, in map depth and in map depth per map pixel of slope
+    float constantBias;
+    float slopeBias;
+    // light left in full shadow
+    float ambient;
+
+    std::vector<cascade_data> cascades;
+};
+
+shadow_data create(size_t mapSize, int cascadeCount, const vec3& direction);
+void destroy(shadow_data& shadow);
+
+// Fits every cascade to its slice of the camera frustum between zNear and zFar and renders the
+// triangles of the world space vertices into it, one cascade per job. viewProjection is the
+// perspective() * view() the screen vertices were made with.
+void render(
+        shadow_data& shadow,
+        const mat4& viewProjection,
+        float zNear,
+        float zFar,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices
+);
+
+// Darkens the shadowed pixels of area after shading, through 4x4 percentage closer filtering.
+// screenToWorld takes screen x, y and depth back to the world. Packed color formats only.
+void apply(
+        const shadow_data& shadow,
+        const mat4& screenToWorld,
+        texture::texture_data& colorTex,
+        const texture::texture_data& depthTex,
+        const texture::rect& area
+);
+// Every sample of the pixels of area, before the resolve.
+void apply(
+        const shadow_data& shadow,
+        const mat4& screenToWorld,
+        msaa::msaa_data& msaa,
+        const texture::rect& area
+);
+
+};// namespace sfr::shadow
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "mesh.hpp"
+#include "math/quat.hpp"
+#include "math/vec.hpp"
+
+#include <span>
+
+namespace sfr::skinning {
+
+// Vertices of mesh posed by the palette, one normalized dual quaternion per joint taking bind
+// space to model space. Each vertex blends its up to 4 joints by weight, 8 vertices at a time
+// across SIMD lanes, with vertex ranges spread over the job pool. out holds one vec3 per vertex;
+// a mesh without weights is copied as it is.
+void skin(const mesh::mesh_data& mesh, std::span<const dualquat> palette, std::span<vec3> out);
+
+};// namespace sfr::skinning
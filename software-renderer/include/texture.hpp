@@ -7,28 +7,81 @@ using color = vec<u8, 3>;
 
 namespace sfr::texture {
 
+// Depth textures hold one float per pixel, rows padded to whole quads and 16-byte aligned.
 enum type {
     Color = 0,
     Depth
 };
 
+// Memory layout of Color textures. The 32-bit formats keep every row 16-byte aligned and padded
+// to a multiple of 4 pixels, so 4-pixel quads can be written with aligned vector stores.
+enum pixel_format {
+    RGB8 = 0,
+    RGBA8,
+    BGRA8
+};
+
+// Pixels minX <= x < maxX and minY <= y < maxY, empty when either range is.
+struct rect {
+    int minX, minY;
+    int maxX, maxY;
+};
+
+bool empty(const rect& area);
+// smallest rect holding both, an empty one adds nothing
+rect merge(const rect& a, const rect& b);
+rect intersect(const rect& a, const rect& b);
+
 struct texture_data {
-    type type;
+    texture::type type;
+    pixel_format format;
 
     size_t width;
     size_t height;
+    size_t stride;
     void* data;
+    bool external;
 };
 
-texture_data create(size_t width, size_t height, type textureType = Color);
+size_t pixelSize(pixel_format format);
+size_t rowStride(size_t width, pixel_format format);
+size_t byteSize(size_t width, size_t height, pixel_format format);
+u32 pack(const color& col, pixel_format format);
+
+texture_data create(
+        size_t width,
+        size_t height,
+        type textureType    = Color,
+        pixel_format format = RGB8
+);
+// Wraps memory owned elsewhere (e.g. a mapped upload buffer), destroy() leaves it alone.
+texture_data wrap(
+        void* data,
+        size_t width,
+        size_t height,
+        type textureType    = Color,
+        pixel_format format = RGB8
+);
 void destroy(texture_data& tex);
 
 void clear(texture_data& tex, const vec3& col);
 void clear(texture_data& tex, const color& col);
+// Only the pixels in area. The packed formats and depth clear whole quads, area.minX and area.maxX
+// are rounded out to multiples of 4.
+void clear(texture_data& tex, const vec3& col, const rect& area);
+void clear(texture_data& tex, const color& col, const rect& area);
 
 float getDepth(texture_data& tex, int x, int y);
-color* getPixel(texture_data& tex, int x, int y);
+color getPixel(texture_data& tex, int x, int y);
 void setPixel(texture_data& tex, int x, int y, const vec3& col);
 void setPixel(texture_data& tex, int x, int y, const color& col);
+// Writes the pixels of the quad starting at x (a multiple of 4) selected by the low 4 bits of
+// mask, with a single aligned store for the 32-bit formats.
+void setPixels(texture_data& tex, int x, int y, int mask, const color& col);
 
-};
\ No newline at end of file
+// Converts row y of a Color texture, writing width pixels of the given format to out.
+void convertRow(const texture_data& tex, size_t y, pixel_format format, void* out);
+// Every row, in ranges spread over the job pool.
+void convert(const texture_data& src, texture_data& dst);
+
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace sfr::tuning {
+
+// Rows per tile of the per pixel passes, which is also the band height triangles are binned by,
+// and the threads the job pool runs, the caller included.
+struct settings {
+    int tileRows;
+    size_t threads;
+};
+
+// What a cache file was calibrated on: the threads the pool starts with (the cores in the affinity
+// mask, or SFR_THREADS), the L2 size, the kernels picked at startup and the resolution. A file
+// calibrated anywhere else is not used.
+std::string signature(int width, int height);
+
+// Renders a synthetic frame of width x height, a few hundred triangles from screen sized ones down
+// to a few pixels, with every tile height and thread count worth trying, and returns the fastest.
+// Thread counts go in powers of two up to the pool's default one. The pool is left as it was.
+settings calibrate(int width, int height);
+
+// Reads settings calibrated on this machine at this resolution, false when path is missing or was
+// calibrated elsewhere.
+bool load(const std::string& path, int width, int height, settings& out);
+void save(const std::string& path, int width, int height, const settings& tuned);
+
+// The settings from path, calibrating and saving them first when it has none for this machine,
+// with the pool restarted on their thread count.
+settings tune(const std::string& path, int width, int height);
+
+};// namespace sfr::tuning
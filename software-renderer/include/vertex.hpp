@@ -0,0 +1,28 @@
+#pragma once
+
+#include "math/mat.hpp"
+#include "math/precision.hpp"
+#include "math/vec.hpp"
+
+#include <span>
+
+namespace sfr::vertex {
+
+// Points through the matrix, w taken as 1 and divided out at the given precision when project is
+// set, in ranges spread over the job pool. out holds one vec3 per point and is never resized. Each
+// point goes through the same kernel whichever range it lands in, so out is the same bit for bit
+// however many workers there are.
+void transform(const mat4& m, std::span<const vec3> points, std::span<vec3> out, bool project, precision divide);
+
+// Vertices to clip space through viewProjection and on to the screen through viewport, both steps
+// done range by range while the range is still in cache.
+void project(
+        const mat4& viewProjection,
+        const mat4& viewport,
+        std::span<const vec3> vertices,
+        std::span<vec3> clip,
+        std::span<vec3> screen,
+        precision divide
+);
+
+};// namespace sfr::vertex
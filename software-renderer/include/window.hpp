@@ -2,33 +2,58 @@
 
 #include "types.hpp"
 #include "texture.hpp"
+#include "present.hpp"
 
 class GLFWwindow;
 
 namespace sfr::window {
-struct window_data {
+// GL objects used to put a frame on screen. Owned by the present thread once the window is up.
+struct window_surface {
     u32 pbo;
     u32 texture;
     u32 program;
     u32 VAO, VBO;
     GLFWwindow* glfwWindow;
 
-    texture::texture_data colorBuf;
+    // persistently mapped ring of frames, null when falling back to copying into the pbo
+    void* mapped;
+    size_t frameBytes;
+    // per slot, set when its upload is queued and waited on when the renderer takes it back
+    void* fences[present::MaxBuffers];
+
+    int width;
+    int height;
+};
+
+struct window_data {
+    window_surface* surface;
+    present::present_data present;
+
+    texture::texture_data* colorBuf;
     texture::texture_data depthBuf;
     int width;
     int height;
 };
 
-window_data init(int width, int height);
+window_data init(
+        int width,
+        int height,
+        int bufferCount              = 2,
+        bool persistentMapping       = true,
+        texture::pixel_format format = texture::BGRA8
+);
 void destroy(window_data& window);
 
 void clear(window_data& window, const color& col);
 void setPixel(window_data& window, int x, int y, const color& col);
+void setPixels(window_data& window, int x, int y, int mask, const color& col);
 void setDepth(window_data& window, int x, int y, const float& depth);
 float getDepth(window_data& window, int x, int y);
 void blitPixels(window_data& window);
 
 void display(window_data& window);
+// Sleeps until the next input event, for frames with nothing to redraw.
+void waitEvents(window_data& window);
 bool shouldClose(window_data& window);
 
 };// namespace sfr::window
@@ -1,5 +1,13 @@
 // clang-format off
 #include "window.hpp"
+#include "raster.hpp"
+#include "msaa.hpp"
+#include "dirty.hpp"
+#include "graph.hpp"
+#include "shadow.hpp"
+#include "vertex.hpp"
+#include "arena.hpp"
+#include "tuning.hpp"
 #include "math/mat.hpp"
 #include "math/vec.hpp"
 #include "math/transform.hpp"
@@ -9,93 +17,38 @@
 
 constexpr int WindowWidth  = 1280;
 constexpr int WindowHeight = WindowWidth * (9.0f / 16.f);
+constexpr int Samples      = 4;
+// vertices land on a 1280x720 grid, 2^-21 of relative error never moves one by a pixel
+constexpr precision PerspectiveDivide = precision::fast;
+// bands the per pixel passes are split into across the job pool
+constexpr int TileRows = WindowHeight / 8;
+// tile rows and threads calibrated on first run and read back from TuningCache after, in place
+// of TileRows and a thread per core
+constexpr bool AutoTune          = false;
+constexpr const char* TuningCache = "sfr_tuning.txt";
+// lay depth down first so every visible pixel is shaded once, msaa targets draw in one pass
+constexpr bool DepthPrepass = Samples == 1;
+constexpr float ZNear       = 0.1f;
+constexpr float ZFar        = 100.f;
+// three 512x512 depth-only cascades; rendering them and applying them to the 1280x720 msaa frame
+// take about a third of what shading that frame does (test/shadow_bench.cpp)
+constexpr int ShadowMapSize  = 512;
+constexpr int ShadowCascades = 3;
+// mesh edges drawn over the frame, depth tested where the depth texture is filled
+constexpr bool Wireframe = false;
 
 const std::vector<color> triangleColors = {
     {255, 0, 0},
     {0, 255, 0},
     {0, 0, 255}
 };
+const std::vector<color> wireframeColors = {{255, 255, 255}};
 // clang-format on
 
-float triangleArea(const vec2& v1, const vec2& v2, const vec2& v3) {
-    auto mat = mat3(v1, v2, v3);
-    return 0.5f * std::abs(det(mat));
-}
-
-void raster(
-        sfr::window::window_data& window,
-        const std::vector<vec3>& vertices,
-        const std::vector<u32>& indices
-) {
-    for (int i = 0; i < indices.size(); i += 3) {
-        auto& color = triangleColors[(i / 3) % 3];
-        auto& v1    = vertices[indices[i + 0]];
-        auto& v2    = vertices[indices[i + 1]];
-        auto& v3    = vertices[indices[i + 2]];
-        auto area   = triangleArea(vec2(v1), vec2(v2), vec2(v3));
-        auto left   = std::min(std::min(v1.x, v2.x), v3.x);
-        auto bottom = std::min(std::min(v1.y, v2.y), v3.y);
-        auto top    = std::max(std::max(v1.y, v2.y), v3.y);
-        auto right  = std::max(std::max(v1.x, v2.x), v3.x);
-        vec2 p{};
-        for (p.y = bottom; p.y <= top; p.y++) {
-            for (p.x = left; p.x <= right; p.x++) {
-                auto subArea1 = triangleArea(p, v2, v3);
-                auto subArea2 = triangleArea(v1, p, v3);
-                auto subArea3 = triangleArea(v1, v2, p);
-
-                auto u = subArea1 / area;
-                auto v = subArea2 / area;
-                auto w = subArea3 / area;
-                auto depth = u * v1.z + v * v2.z + w * v3.z;
-
-                const float eps = 12.f;
-                auto above = sfr::window::getDepth(window, p.x, p.y) >= depth;
-                auto inBounds = (p.x >= 0 && p.x < WindowWidth && p.y >= 0 && p.y < WindowHeight);
-                auto insideTriangle = std::abs(area - (subArea1 + subArea2 + subArea3)) < eps;
-                if (insideTriangle && inBounds && above) {
-                    sfr::window::setPixel(
-                            window,
-                            p.x,
-                            p.y,
-                            color
-                    );
-
-                    sfr::window::setDepth(window, p.x, p.y, depth);
-                }
-            }
-        }
-    }
-}
-
-void viewportTransform(
-        const logic_space& logicSpace,
-        const viewport_space& viewportSpace,
-        const std::vector<vec3>& vertices,
-        std::vector<vec3>& output
-) {
-    auto viewportTransform = viewport(logicSpace, viewportSpace);
-
-    for (int i = 0; i < vertices.size(); i++) {
-        auto v = vec4(vertices[i], 1);
-        output[i] = vec3(viewportTransform * v);
-    }
-}
-
-void clipSpaceTransform(
-        const std::vector<vec3>& vertices,
-        const mat4& transformation,
-        std::vector<vec3>& output
-) {
-    for (int i = 0; i < vertices.size(); i++) {
-        auto v = transformation * vec4(vertices[i], 1);
-        v /= v.w;
-
-        output[i] = vec3(v);
-    }
-}
-
 int main() {
+    // before anything runs on the pool, it restarts on the tuned thread count
+    int tileRows = AutoTune ? sfr::tuning::tune(TuningCache, WindowWidth, WindowHeight).tileRows : TileRows;
+
     auto window = sfr::window::init(WindowWidth, WindowHeight);
 
     auto mesh = sfr::mesh::loadFromFile("C:/Users/grigo/Repos/software-renderer/monkey.obj");
@@ -104,7 +57,7 @@ int main() {
     viewport_space viewportSpace{0, 0, 1280, 720};
 
     mat4 transformation = mat4(1.f);
-    transformation *= perspective(60.f * (M_PI / 180.f), 16.0f / 9.0f, 0.1f, 100.f);
+    transformation *= perspective(60.f * (M_PI / 180.f), 16.0f / 9.0f, ZNear, ZFar);
     transformation *= view(vec3(0, 0, 4), vec3(0, 0, 1), vec3(1, 0, 0), vec3(0, 1, 0));
     //transformation *= translate({1.0f, 0.0f, 0.0f});
 
@@ -115,18 +68,153 @@ int main() {
     //raster(window, viewportVerts, mesh.indices);
     //sfr::window::blitPixels(window);
 
+    sfr::msaa::msaa_data msaa{};
+    if (Samples > 1) {
+        msaa = sfr::msaa::create(WindowWidth, WindowHeight, Samples, window.colorBuf->format);
+    }
+
+    // the mesh is never edited, its version stays put
+    const u64 meshVersion = 0;
+    sfr::dirty::object_data object{};
+    auto tracker    = sfr::dirty::create(WindowWidth, WindowHeight, window.present.bufferCount);
+    auto frameGraph = sfr::graph::create();
+    auto shadow     = sfr::shadow::create(ShadowMapSize, ShadowCascades, vec3(-0.4f, -1.f, -0.6f));
+
     std::vector<vec3> clipspaceVerts(mesh.vertices.size());
-    std::vector<vec3> viewportVerts(mesh.vertices.size());
+    sfr::raster::triangle_buffer triangles;
+    std::vector<sfr::raster::line_setup> lines;
+    auto edges = Wireframe ? sfr::raster::wireframeEdges(mesh.indices) : std::vector<u32>{};
+    mat4 screenToWorld;
+    object.screen.resize(mesh.vertices.size());
     while (!sfr::window::shouldClose(window)) {
-        clipSpaceTransform(mesh.vertices, transformation, clipspaceVerts);
-        // clip out of bounds triangles
-        viewportTransform(logicSpace, viewportSpace, clipspaceVerts, viewportVerts);
+        if (sfr::dirty::stale(object, transformation, meshVersion)) {
+            // both transforms range by range over the job pool, into buffers sized once
+            sfr::vertex::project(
+                    transformation,
+                    viewport(logicSpace, viewportSpace),
+                    mesh.vertices,
+                    clipspaceVerts,
+                    object.screen,
+                    PerspectiveDivide
+            );
+            // clip out of bounds triangles
+            // set up once and shared by every pass and tile drawing the mesh, into the buffers of
+            // the last setup so they stop growing after the first few
+            sfr::raster::setupTriangles(triangles, object.screen, mesh.indices, {0, 0, WindowWidth, WindowHeight});
+            sfr::raster::setupLines(lines, object.screen, edges, {0, 0, WindowWidth, WindowHeight});
+            // a bin per band of tileRows, the tiles of the per pixel passes
+            sfr::raster::binTriangles(triangles, tileRows, WindowHeight);
+            // the cascades follow the camera, they render in parallel with each other
+            sfr::shadow::render(shadow, transformation, ZNear, ZFar, mesh.vertices, mesh.indices);
+            screenToWorld = inverse(viewport(logicSpace, viewportSpace) * transformation);
+            sfr::dirty::update(tracker, object, transformation, meshVersion);
+        }
+
+        // nothing moved, the frame on screen is still right
+        if (!sfr::dirty::pending(tracker)) {
+            sfr::window::waitEvents(window);
+            continue;
+        }
+
+        // msaa storage persists and only misses this frame's changes, back buffers rotate through
+        // the present thread and miss those of the frames drawn into the others as well
+        auto bufferArea = sfr::dirty::bufferArea(tracker);
+        auto drawArea   = Samples > 1 ? sfr::dirty::frameArea(tracker) : bufferArea;
+
+        sfr::graph::reset(frameGraph);
+        auto colorRes   = sfr::graph::importTexture(frameGraph, *window.colorBuf);
+        auto depthRes   = sfr::graph::importTexture(frameGraph, window.depthBuf);
+        auto samplesRes = sfr::graph::importData(frameGraph, WindowWidth, WindowHeight);
+        // what passes touch, in arrays the graph copies so the frame allocates nothing
+        const sfr::graph::resource samplesOnly[] = {samplesRes};
+        const sfr::graph::resource buffers[]     = {colorRes, depthRes};
+        const sfr::graph::resource depthOnly[]   = {depthRes};
+        const sfr::graph::resource colorOnly[]   = {colorRes};
+        auto targets = Samples > 1 ? sfr::graph::resource_list(samplesOnly) : sfr::graph::resource_list(buffers);
+
+        sfr::graph::addPass(frameGraph, "clear", {}, targets, [&](const sfr::texture::rect& tile) {
+            auto area = sfr::texture::intersect(drawArea, tile);
+            if (Samples > 1) {
+                sfr::msaa::clear(msaa, color{}, area);
+            } else {
+                sfr::texture::clear(*window.colorBuf, color{}, area);
+                sfr::texture::clear(window.depthBuf, vec3(1.f), area);
+            }
+        }, tileRows);
+
+        auto rasterTarget = [&](const sfr::texture::rect& tile) {
+            sfr::raster::target_data target{window.colorBuf, &window.depthBuf, nullptr, tile};
+            if (Samples > 1) {
+                target.msaa = &msaa;
+            }
+            return target;
+        };
+        auto visible = [&](const sfr::texture::rect& area) {
+            return !sfr::texture::empty(sfr::texture::intersect(object.bounds, area));
+        };
+
+        if (DepthPrepass) {
+            sfr::graph::addPass(frameGraph, "depth", {}, {depthRes}, [&](const sfr::texture::rect& tile) {
+                auto area = sfr::texture::intersect(drawArea, tile);
+                if (visible(area)) {
+                    auto target = rasterTarget(area);
+                    sfr::raster::drawDepth(target, triangles);
+                }
+            }, tileRows);
+        }
 
-        raster(window, viewportVerts, mesh.indices);
+        auto shadeReads  = DepthPrepass ? sfr::graph::resource_list(depthOnly) : sfr::graph::resource_list();
+        auto shadeWrites = DepthPrepass ? sfr::graph::resource_list(colorOnly) : targets;
+        sfr::graph::addPass(frameGraph, "raster", shadeReads, shadeWrites, [&](const sfr::texture::rect& tile) {
+            auto area = sfr::texture::intersect(drawArea, tile);
+            if (visible(area)) {
+                auto target = rasterTarget(area);
+                sfr::raster::drawTriangles(target, triangles, triangleColors, DepthPrepass);
+            }
+        }, tileRows);
+
+        auto shadowReads = Samples > 1 ? sfr::graph::resource_list(samplesOnly) : sfr::graph::resource_list(buffers);
+        auto shadowWrite = Samples > 1 ? samplesRes : colorRes;
+        sfr::graph::addPass(frameGraph, "shadow", shadowReads, {shadowWrite}, [&](const sfr::texture::rect& tile) {
+            auto area = sfr::texture::intersect(drawArea, tile);
+            if (!visible(area)) {
+                return;
+            }
+            if (Samples > 1) {
+                sfr::shadow::apply(shadow, screenToWorld, msaa, area);
+            } else {
+                sfr::shadow::apply(shadow, screenToWorld, *window.colorBuf, window.depthBuf, area);
+            }
+        }, tileRows);
+
+        if (Samples > 1) {
+            sfr::graph::addPass(frameGraph, "resolve", {samplesRes}, {colorRes}, [&](const sfr::texture::rect& tile) {
+                sfr::msaa::resolve(msaa, *window.colorBuf, sfr::texture::intersect(bufferArea, tile));
+            }, tileRows);
+        }
+
+        if (Wireframe) {
+            sfr::graph::addPass(frameGraph, "wireframe", {depthRes, colorRes}, {colorRes}, [&](const sfr::texture::rect& tile) {
+                // the msaa storage keeps its own depth, the depth texture is never filled then
+                sfr::raster::target_data target{window.colorBuf, &window.depthBuf, nullptr, sfr::texture::intersect(bufferArea, tile)};
+                sfr::raster::drawLines(target, lines, wireframeColors, Samples == 1);
+            }, tileRows);
+        }
+
+        sfr::graph::compile(frameGraph);
+        sfr::graph::execute(frameGraph);
         sfr::window::blitPixels(window);
         sfr::window::display(window);
+        sfr::dirty::advance(tracker);
+        // the scratch of every stage this frame goes at once
+        sfr::arena::nextFrame();
     }
 
+    sfr::graph::destroy(frameGraph);
+    sfr::shadow::destroy(shadow);
+    if (Samples > 1) {
+        sfr::msaa::destroy(msaa);
+    }
     sfr::window::destroy(window);
     return 0;
 }
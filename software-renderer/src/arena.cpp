@@ -0,0 +1,87 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace sfr::arena {
+
+static std::byte* allocateBlock(size_t bytes) {
+    return static_cast<std::byte*>(::operator new[](bytes, std::align_val_t(Alignment)));
+}
+
+static void freeBlock(std::byte* block) {
+    ::operator delete[](block, std::align_val_t(Alignment));
+}
+
+void* allocate(arena_data& arena, size_t bytes) {
+    bytes = (bytes + Alignment - 1) & ~(Alignment - 1);
+    arena.used += bytes;
+    arena.highWater = std::max(arena.highWater, arena.used);
+
+    if (arena.offset + bytes <= arena.capacity) {
+        auto* ret = arena.block + arena.offset;
+        arena.offset += bytes;
+        return ret;
+    }
+    arena.spills.push_back(allocateBlock(std::max(bytes, Alignment)));
+    return arena.spills.back();
+}
+
+marker mark(const arena_data& arena) {
+    return {arena.offset, arena.used, arena.spills.size()};
+}
+
+void rewind(arena_data& arena, const marker& at) {
+    for (auto i = at.spills; i < arena.spills.size(); i++) {
+        freeBlock(arena.spills[i]);
+    }
+    arena.spills.resize(at.spills);
+    arena.offset = at.offset;
+    arena.used   = at.used;
+}
+
+void reset(arena_data& arena) {
+    rewind(arena, {0, 0, 0});
+    if (arena.highWater > arena.capacity) {
+        if (arena.block) {
+            freeBlock(arena.block);
+        }
+        arena.block    = allocateBlock(arena.highWater);
+        arena.capacity = arena.highWater;
+    }
+}
+
+void destroy(arena_data& arena) {
+    reset(arena);
+    if (arena.block) {
+        freeBlock(arena.block);
+    }
+    arena = {};
+}
+
+static std::atomic<u64> frame{0};
+
+// freed with the thread
+struct local_arena {
+    arena_data arena;
+    u64 frame = 0;
+
+    ~local_arena() { destroy(arena); }
+};
+
+arena_data& local() {
+    static thread_local local_arena own;
+    auto current = frame.load(std::memory_order_acquire);
+    if (own.frame != current) {
+        reset(own.arena);
+        own.frame = current;
+    }
+    return own.arena;
+}
+
+void nextFrame() {
+    frame.fetch_add(1, std::memory_order_acq_rel);
+}
+
+};// namespace sfr::arena
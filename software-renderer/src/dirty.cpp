@@ -0,0 +1,96 @@
+#include "dirty.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sfr::dirty {
+
+// Covered pixels, the way raster::setup rounds triangle bounds, then out to whole quads so the
+// quad wide clears and resolves stay inside the area.
+static texture::rect bounds(const tracker_data& tracker, const std::vector<vec3>& vertices) {
+    if (vertices.empty()) {
+        return {0, 0, 0, 0};
+    }
+
+    auto lo = vec2(vertices[0].x, vertices[0].y);
+    auto hi = lo;
+    for (auto& v: vertices) {
+        lo = vec2(std::min(lo.x, v.x), std::min(lo.y, v.y));
+        hi = vec2(std::max(hi.x, v.x), std::max(hi.y, v.y));
+    }
+
+    // far off screen coordinates are clamped before the conversion to int
+    auto limit = float(1 << 30);
+    auto area  = texture::rect{
+            int(std::floor(std::clamp(lo.x, -limit, limit))) & ~3,
+            int(std::floor(std::clamp(lo.y, -limit, limit))),
+            (int(std::ceil(std::clamp(hi.x, -limit, limit))) + 4) & ~3,
+            int(std::ceil(std::clamp(hi.y, -limit, limit))) + 1,
+    };
+    return texture::intersect(area, tracker.screen);
+}
+
+tracker_data create(size_t width, size_t height, int bufferCount) {
+    tracker_data ret;
+    ret.screen      = {0, 0, int(width), int(height)};
+    ret.bufferCount = bufferCount;
+    ret.frame       = ret.screen;
+    for (auto& area: ret.history) {
+        area = ret.screen;
+    }
+    return ret;
+}
+
+void damage(tracker_data& tracker, const texture::rect& area) {
+    tracker.frame = texture::merge(tracker.frame, texture::intersect(area, tracker.screen));
+}
+
+void invalidate(tracker_data& tracker) {
+    tracker.frame = tracker.screen;
+}
+
+bool stale(const object_data& object, const mat4& transform, u64 version) {
+    return !object.cached || object.version != version ||
+           std::memcmp(&object.transform, &transform, sizeof(mat4)) != 0;
+}
+
+void update(tracker_data& tracker, object_data& object, const mat4& transform, u64 version) {
+    if (object.cached) {
+        damage(tracker, object.bounds);
+    }
+
+    object.transform = transform;
+    object.version   = version;
+    object.cached    = true;
+    object.bounds    = bounds(tracker, object.screen);
+    damage(tracker, object.bounds);
+}
+
+bool pending(const tracker_data& tracker) {
+    return !texture::empty(tracker.frame);
+}
+
+texture::rect frameArea(const tracker_data& tracker) {
+    return tracker.frame;
+}
+
+texture::rect bufferArea(const tracker_data& tracker) {
+    auto area = tracker.frame;
+    for (int i = 0; i < tracker.bufferCount - 1; i++) {
+        area = texture::merge(area, tracker.history[i]);
+    }
+    return area;
+}
+
+void advance(tracker_data& tracker) {
+    for (int i = tracker.bufferCount - 2; i > 0; i--) {
+        tracker.history[i] = tracker.history[i - 1];
+    }
+    if (tracker.bufferCount > 1) {
+        tracker.history[0] = tracker.frame;
+    }
+    tracker.frame = {0, 0, 0, 0};
+}
+
+};// namespace sfr::dirty
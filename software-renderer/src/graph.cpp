@@ -0,0 +1,312 @@
+#include "graph.hpp"
+#include "jobs.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace sfr::graph {
+
+constexpr size_t Alignment = 64;
+
+static size_t bytes(const texture_desc& desc) {
+    if (desc.type == texture::Depth) {
+        return ((desc.width + 3) & ~size_t(3)) * desc.height * sizeof(float);
+    }
+    return texture::byteSize(desc.width, desc.height, desc.format);
+}
+
+static bool touches(std::span<const resource> list, resource res) {
+    return std::find(list.begin(), list.end(), res) != list.end();
+}
+
+static bool overlap(std::span<const resource> a, std::span<const resource> b) {
+    for (auto res: a) {
+        if (touches(b, res)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// pass b, added after a, has to wait for it
+static bool dependsOn(const pass_data& b, const pass_data& a) {
+    return overlap(b.reads, a.writes) || overlap(b.writes, a.reads) || overlap(b.writes, a.writes);
+}
+
+graph_data create() {
+    graph_data ret{};
+    return ret;
+}
+
+void destroy(graph_data& graph) {
+    reset(graph);
+    arena::destroy(graph.storage);
+    if (graph.memory) {
+        ::operator delete[](graph.memory, std::align_val_t(Alignment));
+    }
+    graph.memory   = nullptr;
+    graph.capacity = 0;
+}
+
+void reset(graph_data& graph) {
+    graph.resources.clear();
+    graph.passes.clear();
+    graph.levels.clear();
+    arena::reset(graph.storage);
+    graph.used      = 0;
+    graph.unaliased = 0;
+}
+
+resource importTexture(graph_data& graph, texture::texture_data& tex) {
+    resource_data res{};
+    res.desc    = {tex.width, tex.height, tex.type, tex.format};
+    res.texture = tex;
+    graph.resources.push_back(res);
+    return resource(graph.resources.size() - 1);
+}
+
+resource createTexture(graph_data& graph, const texture_desc& desc) {
+    resource_data res{};
+    res.desc      = desc;
+    res.transient = true;
+    graph.resources.push_back(res);
+    return resource(graph.resources.size() - 1);
+}
+
+resource importData(graph_data& graph, size_t width, size_t height) {
+    resource_data res{};
+    res.desc.width  = width;
+    res.desc.height = height;
+    graph.resources.push_back(res);
+    return resource(graph.resources.size() - 1);
+}
+
+template <typename T>
+static std::span<const T> store(arena::arena_data& storage, std::span<const T> items) {
+    auto ret = arena::allocate<T>(storage, items.size());
+    std::copy(items.begin(), items.end(), ret.begin());
+    return ret;
+}
+
+void addPass(
+        graph_data& graph,
+        std::string_view name,
+        resource_list reads,
+        resource_list writes,
+        const std::function<void(const texture::rect& tile)>& execute,
+        int tileRows
+) {
+    auto chars = store<char>(graph.storage, name);
+    graph.passes.push_back({
+            {chars.data(), chars.size()},
+            store(graph.storage, reads.items),
+            store(graph.storage, writes.items),
+            execute,
+            tileRows,
+            0,
+            false
+    });
+}
+
+// Walking back from the last pass, a pass is needed when it writes something imported or read by
+// a needed pass after it.
+static void cull(graph_data& graph) {
+    auto needed = arena::allocate<bool>(arena::local(), graph.resources.size());
+    for (size_t i = 0; i < graph.resources.size(); i++) {
+        needed[i] = !graph.resources[i].transient;
+    }
+
+    for (size_t i = graph.passes.size(); i-- > 0;) {
+        auto& pass  = graph.passes[i];
+        pass.culled = std::none_of(pass.writes.begin(), pass.writes.end(), [&](resource res) {
+            return needed[res];
+        });
+        if (!pass.culled) {
+            for (auto res: pass.reads) {
+                needed[res] = true;
+            }
+        }
+    }
+}
+
+// Levels go one after the other into a single array of the graph's storage, each pass after the
+// ones added before it.
+static void schedule(graph_data& graph) {
+    size_t count = 0, live = 0;
+    for (size_t j = 0; j < graph.passes.size(); j++) {
+        auto& pass = graph.passes[j];
+        if (pass.culled) {
+            continue;
+        }
+
+        pass.level = 0;
+        for (size_t i = 0; i < j; i++) {
+            auto& before = graph.passes[i];
+            if (!before.culled && dependsOn(pass, before)) {
+                pass.level = std::max(pass.level, before.level + 1);
+            }
+        }
+        count = std::max(count, size_t(pass.level + 1));
+        live++;
+    }
+
+    auto starts = arena::allocate<size_t>(arena::local(), count + 1);
+    for (auto& pass: graph.passes) {
+        if (!pass.culled) {
+            starts[pass.level + 1]++;
+        }
+    }
+    for (size_t level = 0; level < count; level++) {
+        starts[level + 1] += starts[level];
+    }
+
+    auto order = arena::allocate<u32>(graph.storage, live);
+    for (size_t level = 0; level < count; level++) {
+        graph.levels.push_back(order.subspan(starts[level], starts[level + 1] - starts[level]));
+    }
+    for (size_t j = 0; j < graph.passes.size(); j++) {
+        auto& pass = graph.passes[j];
+        if (!pass.culled) {
+            order[starts[pass.level]++] = u32(j);
+        }
+    }
+}
+
+// First fit of the transients, largest first, into slots of memory; a texture shares a slot with
+// the ones already in it when none of their levels overlap with its own.
+static void place(graph_data& graph) {
+    for (auto& res: graph.resources) {
+        res.first = int(graph.levels.size());
+        res.last  = -1;
+    }
+    for (auto& pass: graph.passes) {
+        if (pass.culled) {
+            continue;
+        }
+        for (auto* list: {&pass.reads, &pass.writes}) {
+            for (auto res: *list) {
+                graph.resources[res].first = std::min(graph.resources[res].first, pass.level);
+                graph.resources[res].last  = std::max(graph.resources[res].last, pass.level);
+            }
+        }
+    }
+
+    auto& scratch = arena::local();
+    size_t count  = 0;
+    for (auto& res: graph.resources) {
+        count += res.transient && res.last >= 0;
+    }
+    auto order = arena::allocate<u32>(scratch, count);
+    count      = 0;
+    for (size_t i = 0; i < graph.resources.size(); i++) {
+        if (graph.resources[i].transient && graph.resources[i].last >= 0) {
+            order[count++] = u32(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) {
+        return bytes(graph.resources[a].desc) > bytes(graph.resources[b].desc);
+    });
+
+    // a slot's users are the transients placed before with it as their slot
+    struct slot {
+        size_t offset, size;
+    };
+    auto slots   = arena::allocate<slot>(scratch, order.size());
+    auto slotOf  = arena::allocate<u32>(scratch, graph.resources.size());
+    auto offsets = arena::allocate<size_t>(scratch, graph.resources.size());
+    size_t used  = 0;
+    for (size_t k = 0; k < order.size(); k++) {
+        auto idx  = order[k];
+        auto& res = graph.resources[idx];
+        auto size = (bytes(res.desc) + Alignment - 1) & ~(Alignment - 1);
+        graph.unaliased += size;
+
+        auto fits = [&](u32 s) {
+            return slots[s].size >= size && std::none_of(order.begin(), order.begin() + k, [&](u32 other) {
+                auto& o = graph.resources[other];
+                return slotOf[other] == s && o.first <= res.last && res.first <= o.last;
+            });
+        };
+        u32 found = 0;
+        while (found < used && !fits(found)) {
+            found++;
+        }
+        if (found == used) {
+            slots[used++] = {graph.used, size};
+            graph.used += size;
+        }
+        slotOf[idx]  = found;
+        offsets[idx] = slots[found].offset;
+    }
+
+    if (graph.used > graph.capacity) {
+        if (graph.memory) {
+            ::operator delete[](graph.memory, std::align_val_t(Alignment));
+        }
+        graph.memory   = ::operator new[](graph.used, std::align_val_t(Alignment));
+        graph.capacity = graph.used;
+    }
+
+    for (auto idx: order) {
+        auto& res   = graph.resources[idx];
+        auto* data  = static_cast<u8*>(graph.memory) + offsets[idx];
+        res.texture = texture::wrap(data, res.desc.width, res.desc.height, res.desc.type, res.desc.format);
+    }
+}
+
+// Scratch comes from the frame arena and is given back before returning.
+void compile(graph_data& graph) {
+    graph.levels.clear();
+    graph.used      = 0;
+    graph.unaliased = 0;
+
+    auto start = arena::mark(arena::local());
+    cull(graph);
+    schedule(graph);
+    place(graph);
+    arena::rewind(arena::local(), start);
+}
+
+static void run(graph_data& graph, const pass_data& pass) {
+    const texture_desc* target = nullptr;
+    for (auto res: pass.writes) {
+        if (graph.resources[res].desc.width) {
+            target = &graph.resources[res].desc;
+            break;
+        }
+    }
+
+    auto width  = target ? int(target->width) : 0;
+    auto height = target ? int(target->height) : 0;
+    if (pass.tileRows <= 0 || !target) {
+        pass.execute({0, 0, width, height});
+        return;
+    }
+
+    auto rows  = pass.tileRows;
+    auto tiles = size_t((height + rows - 1) / rows);
+    jobs::parallelFor(tiles, 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            auto y = int(i) * rows;
+            pass.execute({0, y, width, std::min(y + rows, height)});
+        }
+    });
+}
+
+void execute(graph_data& graph) {
+    for (auto& level: graph.levels) {
+        jobs::parallelFor(level.size(), 1, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; i++) {
+                run(graph, graph.passes[level[i]]);
+            }
+        });
+    }
+}
+
+texture::texture_data& get(graph_data& graph, resource res) {
+    assert(res < graph.resources.size());
+    return graph.resources[res].texture;
+}
+
+};// namespace sfr::graph
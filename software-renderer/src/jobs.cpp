@@ -0,0 +1,311 @@
+#include "jobs.hpp"
+#include "types.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sfr::jobs {
+
+// A spawned job, or a range of a parallelFor still to be run grain by grain.
+struct task {
+    std::function<void()> job;
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    size_t begin = 0, end = 0, grain = 0;
+    counter* done = nullptr;
+};
+
+// The owner pushes and pops at the back, thieves take from the front where the oldest and, for
+// ranges, largest tasks are. The tasks are a ring only ever grown, steady pushes and pops never
+// allocate.
+struct alignas(64) queue {
+    std::mutex mutex;
+    std::vector<task> tasks;
+    size_t head = 0;
+    std::atomic<size_t> size{0};
+};
+
+static thread_local int self = -1;
+
+// One queue per worker plus a shared one for threads outside the pool. Threads with nothing to
+// run or steal sleep until the epoch moves, which every push and every finished counter does.
+// Idle workers are woken for new tasks and threads waiting on counters for finished ones, or for
+// new tasks when no worker is asleep.
+struct pool {
+    std::vector<std::thread> workers;
+    std::vector<queue> queues;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::atomic<u64> epoch{0};
+    std::atomic<size_t> sleepers{0};
+    std::atomic<size_t> waiters{0};
+    bool stop = false;
+
+    pool() { start(cores()); }
+    ~pool() { shutdown(); }
+
+    void start(size_t threads) {
+        stop   = false;
+        queues = std::vector<queue>(threads);
+
+        auto cpus = allowedCpus();
+        for (size_t i = 0; i + 1 < threads; i++) {
+            workers.emplace_back([this, i] { loop(int(i)); });
+            pin(workers.back(), cpus[(i + 1) % cpus.size()]);
+        }
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& worker: workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    static std::vector<int> allowedCpus() {
+        std::vector<int> ret;
+#ifdef __linux__
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &set)) {
+                    ret.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (ret.empty()) {
+            ret.push_back(-1);
+        }
+        return ret;
+    }
+
+    // a worker per core the process may run on besides the caller's, and the shared queue.
+    // SFR_THREADS sets the number of threads, the caller included, in place of the cores.
+    static size_t cores() {
+        if (auto* threads = std::getenv("SFR_THREADS"); threads && std::atoi(threads) > 0) {
+            return size_t(std::atoi(threads));
+        }
+        auto cpus = allowedCpus();
+        return cpus[0] < 0 ? std::max(std::thread::hardware_concurrency(), 1u) : cpus.size();
+    }
+
+    static void pin(std::thread& thread, int cpu) {
+#ifdef __linux__
+        if (cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+        }
+#endif
+    }
+
+    queue& shared() { return queues.back(); }
+    queue& own() { return self >= 0 ? queues[self] : shared(); }
+
+    void push(task&& t) {
+        auto& q = own();
+        {
+            std::lock_guard lock(q.mutex);
+            auto size = q.size.load(std::memory_order_relaxed);
+            if (size == q.tasks.size()) {
+                std::vector<task> grown(std::max<size_t>(size * 2, 16));
+                for (size_t i = 0; i < size; i++) {
+                    grown[i] = std::move(q.tasks[(q.head + i) % size]);
+                }
+                q.tasks.swap(grown);
+                q.head = 0;
+            }
+            q.tasks[(q.head + size) % q.tasks.size()] = std::move(t);
+            q.size.store(size + 1, std::memory_order_relaxed);
+        }
+        epoch.fetch_add(1);
+        if (sleepers.load() > 0) {
+            std::lock_guard lock(mutex);
+            wake.notify_one();
+        } else if (waiters.load() > 0) {
+            std::lock_guard lock(mutex);
+            finished.notify_one();
+        }
+    }
+
+    static bool take(queue& q, task& t, bool back) {
+        if (q.size.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        std::lock_guard lock(q.mutex);
+        auto size = q.size.load(std::memory_order_relaxed);
+        if (size == 0) {
+            return false;
+        }
+        if (back) {
+            t = std::move(q.tasks[(q.head + size - 1) % q.tasks.size()]);
+        } else {
+            t = std::move(q.tasks[q.head]);
+            q.head = (q.head + 1) % q.tasks.size();
+        }
+        q.size.store(size - 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // own queue first, then the shared one, then the other workers from the next one on
+    bool find(task& t) {
+        if (self >= 0 && take(queues[self], t, true)) {
+            return true;
+        }
+        if (take(shared(), t, self < 0)) {
+            return true;
+        }
+        // queues is sized before any worker starts, workers still grows while the first ones run
+        auto count = queues.size() - 1;
+        auto start = self >= 0 ? size_t(self) + 1 : 0;
+        for (size_t i = 0; i < count; i++) {
+            auto victim = (start + i) % count;
+            if (int(victim) != self && take(queues[victim], t, false)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void finish(counter& done) {
+        // done may be gone as soon as it reaches zero, only the pool is touched after
+        if (done.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            epoch.fetch_add(1);
+            if (waiters.load() > 0) {
+                std::lock_guard lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    void run(task& t) {
+        if (!t.body) {
+            t.job();
+            finish(*t.done);
+            return;
+        }
+
+        // lazy splitting: half of what is left goes back to the queue whenever it ran dry, so
+        // ranges only spread as far as there are idle threads to take them
+        auto begin = t.begin, end = t.end;
+        while (begin < end) {
+            auto chunks = (end - begin + t.grain - 1) / t.grain;
+            if (chunks > 1 && own().size.load(std::memory_order_relaxed) == 0) {
+                auto middle = begin + chunks / 2 * t.grain;
+                t.done->pending.fetch_add(1, std::memory_order_relaxed);
+                push({{}, t.body, middle, end, t.grain, t.done});
+                end = middle;
+                continue;
+            }
+
+            auto last = std::min(begin + t.grain, end);
+            (*t.body)(begin, last);
+            begin = last;
+        }
+        finish(*t.done);
+    }
+
+    // sleeps on signal unless the epoch moved on from seen, false once the pool is stopping
+    bool idle(u64 seen, std::condition_variable& signal, std::atomic<size_t>& asleep) {
+        std::unique_lock lock(mutex);
+        asleep.fetch_add(1);
+        while (!stop && epoch.load() == seen) {
+            signal.wait(lock);
+        }
+        asleep.fetch_sub(1);
+        return !stop;
+    }
+
+    void loop(int index) {
+        self = index;
+        while (true) {
+            auto seen = epoch.load();
+            task t;
+            if (find(t)) {
+                run(t);
+            } else if (!idle(seen, wake, sleepers)) {
+                return;
+            }
+        }
+    }
+
+    void help(counter& done) {
+        while (done.pending.load(std::memory_order_acquire) != 0) {
+            auto seen = epoch.load();
+            task t;
+            if (find(t)) {
+                run(t);
+            } else if (done.pending.load(std::memory_order_acquire) != 0) {
+                idle(seen, finished, waiters);
+            }
+        }
+    }
+};
+
+static pool& instance() {
+    static pool instance;
+    return instance;
+}
+
+void spawn(counter& done, std::function<void()> job) {
+    auto& jobs = instance();
+    done.pending.fetch_add(1, std::memory_order_relaxed);
+    jobs.push({std::move(job), nullptr, 0, 0, 0, &done});
+}
+
+void wait(counter& done) {
+    instance().help(done);
+}
+
+void setThreads(size_t threads) {
+    auto& jobs = instance();
+    if (threads == 0 || threads == jobs.queues.size()) {
+        return;
+    }
+    jobs.shutdown();
+    jobs.start(threads);
+}
+
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body) {
+    grain = std::max<size_t>(grain, 1);
+    auto& jobs = instance();
+    if (count <= grain || jobs.workers.empty()) {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(begin + grain, count));
+        }
+        return;
+    }
+
+    counter done;
+    done.pending.store(1, std::memory_order_relaxed);
+    task t{{}, &body, 0, count, grain, &done};
+    jobs.run(t);
+    jobs.help(done);
+}
+
+size_t workerCount() {
+    return instance().workers.size() + 1;
+}
+
+size_t defaultThreads() {
+    return pool::cores();
+}
+
+};// namespace sfr::jobs
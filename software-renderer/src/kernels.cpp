@@ -0,0 +1,81 @@
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace sfr::kernels {
+
+// one per kernels_<isa>.cpp, each built with its own instruction set flags
+extern const kernel_table sse41Kernels;
+extern const kernel_table avx2Kernels;
+extern const kernel_table avx512Kernels;
+
+static std::atomic<int> selected{-1};
+
+static isa fromEnvironment(isa best) {
+    auto* value = std::getenv("SFR_ISA");
+    if (!value) {
+        return best;
+    }
+
+    for (int i = SSE41; i <= AVX512; i++) {
+        if (std::strcmp(value, name(isa(i))) == 0) {
+            return std::min(best, isa(i));
+        }
+    }
+    return best;
+}
+
+isa detect() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+    return SSE41;
+}
+
+isa active() {
+    auto current = selected.load(std::memory_order_relaxed);
+    if (current < 0) {
+        current = fromEnvironment(detect());
+        selected.store(current, std::memory_order_relaxed);
+    }
+    return isa(current);
+}
+
+isa select(isa target) {
+    auto used = std::min(target, detect());
+    selected.store(used, std::memory_order_relaxed);
+    return used;
+}
+
+const char* name(isa target) {
+    switch (target) {
+    case AVX2:
+        return "avx2";
+    case AVX512:
+        return "avx512";
+    default:
+        return "sse4.1";
+    }
+}
+
+const kernel_table& get() { return get(active()); }
+
+const kernel_table& get(isa target) {
+    switch (target) {
+    case AVX2:
+        return avx2Kernels;
+    case AVX512:
+        return avx512Kernels;
+    default:
+        return sse41Kernels;
+    }
+}
+
+};// namespace sfr::kernels
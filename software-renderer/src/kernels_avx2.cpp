@@ -0,0 +1,248 @@
+#include "kernels.hpp"
+
+#include <immintrin.h>
+
+// Eight lanes per step, see kernels_sse41.cpp for the rules every variant follows.
+namespace sfr::kernels {
+
+static void fill32(void* dst, u32 value, size_t count) {
+    auto* data = static_cast<u32*>(dst);
+    auto reg   = _mm256_set1_epi32(value);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&data[i]), reg);
+    }
+    for (; i < count; i++) {
+        data[i] = value;
+    }
+}
+
+// r / r.w, rcpps is the same estimate at either width so the tail matches the body
+static __m256 divideByW(__m256 r, precision divide) {
+    auto w = _mm256_permute_ps(r, 0xFF);
+    if (divide == precision::exact) {
+        return _mm256_div_ps(r, w);
+    }
+
+    auto inv = _mm256_rcp_ps(w);
+    if (divide == precision::fast) {
+        inv = _mm256_mul_ps(inv, _mm256_sub_ps(_mm256_set1_ps(2.f), _mm256_mul_ps(w, inv)));
+    }
+    return _mm256_mul_ps(r, inv);
+}
+
+static __m128 divideByW(__m128 r, precision divide) {
+    auto w = _mm_permute_ps(r, 0xFF);
+    if (divide == precision::exact) {
+        return _mm_div_ps(r, w);
+    }
+
+    auto inv = _mm_rcp_ps(w);
+    if (divide == precision::fast) {
+        inv = _mm_mul_ps(inv, _mm_sub_ps(_mm_set1_ps(2.f), _mm_mul_ps(w, inv)));
+    }
+    return _mm_mul_ps(r, inv);
+}
+
+static void transformPoints(
+        const float* m,
+        const float* src,
+        float* dst,
+        size_t count,
+        bool project,
+        precision divide
+) {
+    auto c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+    auto c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    auto c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    auto c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+
+    // two points per register, one in each 128 bit half
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        auto p = _mm256_loadu_ps(src + i * 4);
+        auto r = _mm256_add_ps(
+                _mm256_add_ps(
+                        _mm256_add_ps(
+                                _mm256_mul_ps(c0, _mm256_permute_ps(p, 0x00)),
+                                _mm256_mul_ps(c1, _mm256_permute_ps(p, 0x55))
+                        ),
+                        _mm256_mul_ps(c2, _mm256_permute_ps(p, 0xAA))
+                ),
+                c3
+        );
+        if (project) {
+            r = divideByW(r, divide);
+        }
+        _mm256_storeu_ps(dst + i * 4, r);
+    }
+
+    if (i < count) {
+        auto p = _mm_loadu_ps(src + i * 4);
+        auto r = _mm_add_ps(
+                _mm_add_ps(
+                        _mm_add_ps(
+                                _mm_mul_ps(_mm256_castps256_ps128(c0), _mm_permute_ps(p, 0x00)),
+                                _mm_mul_ps(_mm256_castps256_ps128(c1), _mm_permute_ps(p, 0x55))
+                        ),
+                        _mm_mul_ps(_mm256_castps256_ps128(c2), _mm_permute_ps(p, 0xAA))
+                ),
+                _mm256_castps256_ps128(c3)
+        );
+        if (project) {
+            r = divideByW(r, divide);
+        }
+        _mm_storeu_ps(dst + i * 4, r);
+    }
+}
+
+static void shuffle32(const u32* src, u32* dst, size_t count, const u8* control) {
+    // vpshufb works within 128 bit halves, which is exactly one run of 4 pixels
+    auto mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)));
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(pixels, mask));
+    }
+    if (i < count) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + i),
+                _mm_shuffle_epi8(pixels, _mm256_castsi256_si128(mask))
+        );
+    }
+}
+
+template <bool Covered>
+static void fillRow(
+        const triangle_edges& tri,
+        int y,
+        int minX,
+        int maxX,
+        float* depths,
+        u32* colors,
+        u32 packed,
+        bool equal
+) {
+    auto py      = _mm256_set1_ps(y + 0.5f);
+    auto lo      = _mm256_set1_ps(float(minX));
+    auto hi      = _mm256_set1_ps(float(maxX + 1));
+    auto centers = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    auto value   = _mm256_set1_epi32(packed);
+
+    // the rows are only padded to quads, lanes past the end are never loaded or stored
+    for (int x = minX & ~3; x <= maxX; x += 8) {
+        auto px     = _mm256_add_ps(_mm256_set1_ps(float(x)), centers);
+        auto valid  = _mm256_and_ps(_mm256_cmp_ps(px, lo, _CMP_GT_OQ), _mm256_cmp_ps(px, hi, _CMP_LT_OQ));
+        auto inside = valid;
+
+        __m256 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = _mm256_add_ps(
+                    _mm256_add_ps(
+                            _mm256_mul_ps(_mm256_set1_ps(tri.a[i]), px),
+                            _mm256_mul_ps(_mm256_set1_ps(tri.b[i]), py)
+                    ),
+                    _mm256_set1_ps(tri.c[i])
+            );
+
+            if (!Covered) {
+                auto edge = _mm256_cmp_ps(w[i], _mm256_setzero_ps(), _CMP_GT_OQ);
+                if (tri.topLeft[i]) {
+                    edge = _mm256_or_ps(edge, _mm256_cmp_ps(w[i], _mm256_setzero_ps(), _CMP_EQ_OQ));
+                }
+                inside = _mm256_and_ps(inside, edge);
+            }
+        }
+        if (!_mm256_movemask_ps(inside)) {
+            continue;
+        }
+
+        auto depth = _mm256_mul_ps(
+                _mm256_add_ps(
+                        _mm256_add_ps(
+                                _mm256_mul_ps(w[0], _mm256_set1_ps(tri.z[0])),
+                                _mm256_mul_ps(w[1], _mm256_set1_ps(tri.z[1]))
+                        ),
+                        _mm256_mul_ps(w[2], _mm256_set1_ps(tri.z[2]))
+                ),
+                _mm256_set1_ps(tri.invArea)
+        );
+        auto old  = _mm256_maskload_ps(&depths[x], _mm256_castps_si256(valid));
+        auto test = equal ? _mm256_cmp_ps(old, depth, _CMP_EQ_OQ) : _mm256_cmp_ps(old, depth, _CMP_GE_OQ);
+        auto pass = _mm256_and_ps(inside, test);
+        if (!_mm256_movemask_ps(pass)) {
+            continue;
+        }
+
+        auto passMask = _mm256_castps_si256(pass);
+        if (!equal) {
+            _mm256_maskstore_ps(&depths[x], passMask, depth);
+        }
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(&colors[x]), passMask, value);
+    }
+}
+
+template <bool Covered>
+static void depthRow(const triangle_edges& tri, int y, int minX, int maxX, float* depths) {
+    auto py      = _mm256_set1_ps(y + 0.5f);
+    auto lo      = _mm256_set1_ps(float(minX));
+    auto hi      = _mm256_set1_ps(float(maxX + 1));
+    auto centers = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+
+    for (int x = minX & ~3; x <= maxX; x += 8) {
+        auto px     = _mm256_add_ps(_mm256_set1_ps(float(x)), centers);
+        auto valid  = _mm256_and_ps(_mm256_cmp_ps(px, lo, _CMP_GT_OQ), _mm256_cmp_ps(px, hi, _CMP_LT_OQ));
+        auto inside = valid;
+
+        __m256 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = _mm256_add_ps(
+                    _mm256_add_ps(
+                            _mm256_mul_ps(_mm256_set1_ps(tri.a[i]), px),
+                            _mm256_mul_ps(_mm256_set1_ps(tri.b[i]), py)
+                    ),
+                    _mm256_set1_ps(tri.c[i])
+            );
+
+            if (!Covered) {
+                auto edge = _mm256_cmp_ps(w[i], _mm256_setzero_ps(), _CMP_GT_OQ);
+                if (tri.topLeft[i]) {
+                    edge = _mm256_or_ps(edge, _mm256_cmp_ps(w[i], _mm256_setzero_ps(), _CMP_EQ_OQ));
+                }
+                inside = _mm256_and_ps(inside, edge);
+            }
+        }
+        if (!_mm256_movemask_ps(inside)) {
+            continue;
+        }
+
+        auto depth = _mm256_mul_ps(
+                _mm256_add_ps(
+                        _mm256_add_ps(
+                                _mm256_mul_ps(w[0], _mm256_set1_ps(tri.z[0])),
+                                _mm256_mul_ps(w[1], _mm256_set1_ps(tri.z[1]))
+                        ),
+                        _mm256_mul_ps(w[2], _mm256_set1_ps(tri.z[2]))
+                ),
+                _mm256_set1_ps(tri.invArea)
+        );
+        auto old = _mm256_maskload_ps(&depths[x], _mm256_castps_si256(valid));
+        _mm256_maskstore_ps(&depths[x], _mm256_castps_si256(inside), _mm256_min_ps(old, depth));
+    }
+}
+
+extern const kernel_table avx2Kernels = {
+        AVX2,
+        fill32,
+        transformPoints,
+        shuffle32,
+        fillRow<false>,
+        depthRow<false>,
+        fillRow<true>,
+        depthRow<true>,
+};
+
+};// namespace sfr::kernels
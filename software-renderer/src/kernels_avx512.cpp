@@ -0,0 +1,215 @@
+#include "kernels.hpp"
+
+#include <immintrin.h>
+
+// Sixteen lanes per step with mask registers, see kernels_sse41.cpp for the rules every variant
+// follows.
+namespace sfr::kernels {
+
+static void fill32(void* dst, u32 value, size_t count) {
+    auto* data = static_cast<u32*>(dst);
+    auto reg   = _mm512_set1_epi32(value);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_si512(&data[i], reg);
+    }
+    if (i < count) {
+        _mm512_mask_storeu_epi32(&data[i], __mmask16((1u << (count - i)) - 1), reg);
+    }
+}
+
+// r / r.w, the rcp14 estimate is finer than rcpps so approximate results differ from the other
+// variants, though always within the bound
+static __m512 divideByW(__m512 r, precision divide) {
+    auto w = _mm512_permute_ps(r, 0xFF);
+    if (divide == precision::exact) {
+        return _mm512_div_ps(r, w);
+    }
+
+    auto inv = _mm512_rcp14_ps(w);
+    if (divide == precision::fast) {
+        inv = _mm512_mul_ps(inv, _mm512_sub_ps(_mm512_set1_ps(2.f), _mm512_mul_ps(w, inv)));
+    }
+    return _mm512_mul_ps(r, inv);
+}
+
+static void transformPoints(
+        const float* m,
+        const float* src,
+        float* dst,
+        size_t count,
+        bool project,
+        precision divide
+) {
+    auto c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(m));
+    auto c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 4));
+    auto c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 8));
+    auto c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(m + 12));
+
+    // four points per register, the last partial group through a lane mask
+    for (size_t i = 0; i < count; i += 4) {
+        auto lanes = count - i < 4 ? __mmask16((1u << ((count - i) * 4)) - 1) : __mmask16(0xFFFF);
+        auto p     = _mm512_maskz_loadu_ps(lanes, src + i * 4);
+        auto r     = _mm512_add_ps(
+                _mm512_add_ps(
+                        _mm512_add_ps(
+                                _mm512_mul_ps(c0, _mm512_permute_ps(p, 0x00)),
+                                _mm512_mul_ps(c1, _mm512_permute_ps(p, 0x55))
+                        ),
+                        _mm512_mul_ps(c2, _mm512_permute_ps(p, 0xAA))
+                ),
+                c3
+        );
+        if (project) {
+            r = divideByW(r, divide);
+        }
+        _mm512_mask_storeu_ps(dst + i * 4, lanes, r);
+    }
+}
+
+static void shuffle32(const u32* src, u32* dst, size_t count, const u8* control) {
+    auto mask = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)));
+
+    for (size_t i = 0; i < count; i += 16) {
+        auto lanes  = count - i < 16 ? __mmask16((1u << (count - i)) - 1) : __mmask16(0xFFFF);
+        auto pixels = _mm512_maskz_loadu_epi32(lanes, src + i);
+        _mm512_mask_storeu_epi32(dst + i, lanes, _mm512_shuffle_epi8(pixels, mask));
+    }
+}
+
+template <bool Covered>
+static void fillRow(
+        const triangle_edges& tri,
+        int y,
+        int minX,
+        int maxX,
+        float* depths,
+        u32* colors,
+        u32 packed,
+        bool equal
+) {
+    auto py      = _mm512_set1_ps(y + 0.5f);
+    auto lo      = _mm512_set1_ps(float(minX));
+    auto hi      = _mm512_set1_ps(float(maxX + 1));
+    auto centers = _mm512_setr_ps(
+            0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+            8.5f, 9.5f, 10.5f, 11.5f, 12.5f, 13.5f, 14.5f, 15.5f
+    );
+    auto value = _mm512_set1_epi32(packed);
+
+    for (int x = minX & ~3; x <= maxX; x += 16) {
+        auto px     = _mm512_add_ps(_mm512_set1_ps(float(x)), centers);
+        auto valid  = _mm512_cmp_ps_mask(px, lo, _CMP_GT_OQ) & _mm512_cmp_ps_mask(px, hi, _CMP_LT_OQ);
+        auto inside = valid;
+
+        __m512 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = _mm512_add_ps(
+                    _mm512_add_ps(
+                            _mm512_mul_ps(_mm512_set1_ps(tri.a[i]), px),
+                            _mm512_mul_ps(_mm512_set1_ps(tri.b[i]), py)
+                    ),
+                    _mm512_set1_ps(tri.c[i])
+            );
+
+            if (!Covered) {
+                auto edge = _mm512_cmp_ps_mask(w[i], _mm512_setzero_ps(), _CMP_GT_OQ);
+                if (tri.topLeft[i]) {
+                    edge |= _mm512_cmp_ps_mask(w[i], _mm512_setzero_ps(), _CMP_EQ_OQ);
+                }
+                inside &= edge;
+            }
+        }
+        if (!inside) {
+            continue;
+        }
+
+        auto depth = _mm512_mul_ps(
+                _mm512_add_ps(
+                        _mm512_add_ps(
+                                _mm512_mul_ps(w[0], _mm512_set1_ps(tri.z[0])),
+                                _mm512_mul_ps(w[1], _mm512_set1_ps(tri.z[1]))
+                        ),
+                        _mm512_mul_ps(w[2], _mm512_set1_ps(tri.z[2]))
+                ),
+                _mm512_set1_ps(tri.invArea)
+        );
+        auto old  = _mm512_maskz_loadu_ps(valid, &depths[x]);
+        auto test = equal ? _mm512_cmp_ps_mask(old, depth, _CMP_EQ_OQ) : _mm512_cmp_ps_mask(old, depth, _CMP_GE_OQ);
+        auto pass = __mmask16(inside & test);
+        if (!pass) {
+            continue;
+        }
+
+        if (!equal) {
+            _mm512_mask_storeu_ps(&depths[x], pass, depth);
+        }
+        _mm512_mask_storeu_epi32(&colors[x], pass, value);
+    }
+}
+
+template <bool Covered>
+static void depthRow(const triangle_edges& tri, int y, int minX, int maxX, float* depths) {
+    auto py      = _mm512_set1_ps(y + 0.5f);
+    auto lo      = _mm512_set1_ps(float(minX));
+    auto hi      = _mm512_set1_ps(float(maxX + 1));
+    auto centers = _mm512_setr_ps(
+            0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+            8.5f, 9.5f, 10.5f, 11.5f, 12.5f, 13.5f, 14.5f, 15.5f
+    );
+
+    for (int x = minX & ~3; x <= maxX; x += 16) {
+        auto px     = _mm512_add_ps(_mm512_set1_ps(float(x)), centers);
+        auto valid  = _mm512_cmp_ps_mask(px, lo, _CMP_GT_OQ) & _mm512_cmp_ps_mask(px, hi, _CMP_LT_OQ);
+        auto inside = valid;
+
+        __m512 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = _mm512_add_ps(
+                    _mm512_add_ps(
+                            _mm512_mul_ps(_mm512_set1_ps(tri.a[i]), px),
+                            _mm512_mul_ps(_mm512_set1_ps(tri.b[i]), py)
+                    ),
+                    _mm512_set1_ps(tri.c[i])
+            );
+
+            if (!Covered) {
+                auto edge = _mm512_cmp_ps_mask(w[i], _mm512_setzero_ps(), _CMP_GT_OQ);
+                if (tri.topLeft[i]) {
+                    edge |= _mm512_cmp_ps_mask(w[i], _mm512_setzero_ps(), _CMP_EQ_OQ);
+                }
+                inside &= edge;
+            }
+        }
+        if (!inside) {
+            continue;
+        }
+
+        auto depth = _mm512_mul_ps(
+                _mm512_add_ps(
+                        _mm512_add_ps(
+                                _mm512_mul_ps(w[0], _mm512_set1_ps(tri.z[0])),
+                                _mm512_mul_ps(w[1], _mm512_set1_ps(tri.z[1]))
+                        ),
+                        _mm512_mul_ps(w[2], _mm512_set1_ps(tri.z[2]))
+                ),
+                _mm512_set1_ps(tri.invArea)
+        );
+        auto old = _mm512_maskz_loadu_ps(valid, &depths[x]);
+        _mm512_mask_storeu_ps(&depths[x], inside, _mm512_min_ps(old, depth));
+    }
+}
+
+extern const kernel_table avx512Kernels = {
+        AVX512,
+        fill32,
+        transformPoints,
+        shuffle32,
+        fillRow<false>,
+        depthRow<false>,
+        fillRow<true>,
+        depthRow<true>,
+};
+
+};// namespace sfr::kernels
@@ -0,0 +1,193 @@
+#include "kernels.hpp"
+
+#include <smmintrin.h>
+
+// Reference variant, the others must match it bit for bit. Only intrinsics and functions local
+// to this file may be used here, inline code shared with other files would be built for
+// whichever instruction set the linker happens to keep.
+namespace sfr::kernels {
+
+static void fill32(void* dst, u32 value, size_t count) {
+    auto* data = static_cast<u32*>(dst);
+    auto reg   = _mm_set1_epi32(value);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(&data[i]), reg);
+    }
+    for (; i < count; i++) {
+        data[i] = value;
+    }
+}
+
+// r / r.w
+static __m128 divideByW(__m128 r, precision divide) {
+    auto w = _mm_shuffle_ps(r, r, 0xFF);
+    if (divide == precision::exact) {
+        return _mm_div_ps(r, w);
+    }
+
+    auto inv = _mm_rcp_ps(w);
+    if (divide == precision::fast) {
+        inv = _mm_mul_ps(inv, _mm_sub_ps(_mm_set1_ps(2.f), _mm_mul_ps(w, inv)));
+    }
+    return _mm_mul_ps(r, inv);
+}
+
+static void transformPoints(
+        const float* m,
+        const float* src,
+        float* dst,
+        size_t count,
+        bool project,
+        precision divide
+) {
+    auto c0 = _mm_loadu_ps(m);
+    auto c1 = _mm_loadu_ps(m + 4);
+    auto c2 = _mm_loadu_ps(m + 8);
+    auto c3 = _mm_loadu_ps(m + 12);
+
+    for (size_t i = 0; i < count; i++) {
+        auto p = _mm_loadu_ps(src + i * 4);
+        auto r = _mm_add_ps(
+                _mm_add_ps(
+                        _mm_add_ps(
+                                _mm_mul_ps(c0, _mm_shuffle_ps(p, p, 0x00)),
+                                _mm_mul_ps(c1, _mm_shuffle_ps(p, p, 0x55))
+                        ),
+                        _mm_mul_ps(c2, _mm_shuffle_ps(p, p, 0xAA))
+                ),
+                c3
+        );
+        if (project) {
+            r = divideByW(r, divide);
+        }
+        _mm_storeu_ps(dst + i * 4, r);
+    }
+}
+
+static void shuffle32(const u32* src, u32* dst, size_t count, const u8* control) {
+    auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+    for (size_t i = 0; i < count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(pixels, mask));
+    }
+}
+
+template <bool Covered>
+static void fillRow(
+        const triangle_edges& tri,
+        int y,
+        int minX,
+        int maxX,
+        float* depths,
+        u32* colors,
+        u32 packed,
+        bool equal
+) {
+    auto py      = _mm_set1_ps(y + 0.5f);
+    auto lo      = _mm_set1_ps(float(minX));
+    auto hi      = _mm_set1_ps(float(maxX + 1));
+    auto centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    auto value   = _mm_set1_epi32(packed);
+
+    for (int x = minX & ~3; x <= maxX; x += 4) {
+        auto px     = _mm_add_ps(_mm_set1_ps(float(x)), centers);
+        auto inside = _mm_and_ps(_mm_cmpgt_ps(px, lo), _mm_cmplt_ps(px, hi));
+
+        __m128 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.a[i]), px), _mm_mul_ps(_mm_set1_ps(tri.b[i]), py)),
+                    _mm_set1_ps(tri.c[i])
+            );
+
+            if (!Covered) {
+                auto edge = _mm_cmpgt_ps(w[i], _mm_setzero_ps());
+                if (tri.topLeft[i]) {
+                    edge = _mm_or_ps(edge, _mm_cmpeq_ps(w[i], _mm_setzero_ps()));
+                }
+                inside = _mm_and_ps(inside, edge);
+            }
+        }
+        if (!_mm_movemask_ps(inside)) {
+            continue;
+        }
+
+        auto depth = _mm_mul_ps(
+                _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(w[0], _mm_set1_ps(tri.z[0])), _mm_mul_ps(w[1], _mm_set1_ps(tri.z[1]))),
+                        _mm_mul_ps(w[2], _mm_set1_ps(tri.z[2]))
+                ),
+                _mm_set1_ps(tri.invArea)
+        );
+        auto old  = _mm_load_ps(&depths[x]);
+        auto test = equal ? _mm_cmpeq_ps(old, depth) : _mm_cmpge_ps(old, depth);
+        auto pass = _mm_and_ps(inside, test);
+        if (!_mm_movemask_ps(pass)) {
+            continue;
+        }
+
+        auto* quad = reinterpret_cast<__m128i*>(&colors[x]);
+        if (!equal) {
+            _mm_store_ps(&depths[x], _mm_blendv_ps(old, depth, pass));
+        }
+        _mm_store_si128(quad, _mm_blendv_epi8(_mm_load_si128(quad), value, _mm_castps_si128(pass)));
+    }
+}
+
+template <bool Covered>
+static void depthRow(const triangle_edges& tri, int y, int minX, int maxX, float* depths) {
+    auto py      = _mm_set1_ps(y + 0.5f);
+    auto lo      = _mm_set1_ps(float(minX));
+    auto hi      = _mm_set1_ps(float(maxX + 1));
+    auto centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (int x = minX & ~3; x <= maxX; x += 4) {
+        auto px     = _mm_add_ps(_mm_set1_ps(float(x)), centers);
+        auto inside = _mm_and_ps(_mm_cmpgt_ps(px, lo), _mm_cmplt_ps(px, hi));
+
+        __m128 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.a[i]), px), _mm_mul_ps(_mm_set1_ps(tri.b[i]), py)),
+                    _mm_set1_ps(tri.c[i])
+            );
+
+            if (!Covered) {
+                auto edge = _mm_cmpgt_ps(w[i], _mm_setzero_ps());
+                if (tri.topLeft[i]) {
+                    edge = _mm_or_ps(edge, _mm_cmpeq_ps(w[i], _mm_setzero_ps()));
+                }
+                inside = _mm_and_ps(inside, edge);
+            }
+        }
+        if (!_mm_movemask_ps(inside)) {
+            continue;
+        }
+
+        // the same sums as fillRow, so the shading pass finds exactly these values
+        auto depth = _mm_mul_ps(
+                _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(w[0], _mm_set1_ps(tri.z[0])), _mm_mul_ps(w[1], _mm_set1_ps(tri.z[1]))),
+                        _mm_mul_ps(w[2], _mm_set1_ps(tri.z[2]))
+                ),
+                _mm_set1_ps(tri.invArea)
+        );
+        auto old = _mm_load_ps(&depths[x]);
+        _mm_store_ps(&depths[x], _mm_blendv_ps(old, _mm_min_ps(old, depth), inside));
+    }
+}
+
+extern const kernel_table sse41Kernels = {
+        SSE41,
+        fill32,
+        transformPoints,
+        shuffle32,
+        fillRow<false>,
+        depthRow<false>,
+        fillRow<true>,
+        depthRow<true>,
+};
+
+};// namespace sfr::kernels
@@ -23,8 +23,9 @@ mesh_data loadFromFile(const std::string& path) {
     }
 
     for (int i = 0; i < mesh->position_count; i++) {
-        auto* vertex = reinterpret_cast<vec3*>(&mesh->positions[i * 3]);
-        data.vertices[i] = *vertex;
+        // positions are tightly packed, vec3 is padded to a full register
+        auto* position   = &mesh->positions[i * 3];
+        data.vertices[i] = vec3(position[0], position[1], position[2]);
     }
 
     return data;
@@ -0,0 +1,192 @@
+#include "msaa.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace sfr::msaa {
+
+constexpr size_t Alignment = 64;
+
+// in 1/16th of a pixel
+static const vec2 positions1[] = {{0, 0}};
+static const vec2 positions4[] = {
+    {-2 / 16.f, -6 / 16.f},
+    {6 / 16.f, -2 / 16.f},
+    {-6 / 16.f, 2 / 16.f},
+    {2 / 16.f, 6 / 16.f},
+};
+static const vec2 positions8[] = {
+    {1 / 16.f, -3 / 16.f},
+    {-1 / 16.f, 3 / 16.f},
+    {5 / 16.f, 1 / 16.f},
+    {-3 / 16.f, -5 / 16.f},
+    {-5 / 16.f, 5 / 16.f},
+    {-7 / 16.f, -1 / 16.f},
+    {3 / 16.f, 7 / 16.f},
+    {7 / 16.f, -7 / 16.f},
+};
+
+template <typename T>
+static T* allocate(size_t count) {
+    return static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t(Alignment)));
+}
+
+template <typename T>
+static void release(T*& data) {
+    ::operator delete[](data, std::align_val_t(Alignment));
+    data = nullptr;
+}
+
+// area clipped to the image, x rounded out to whole quads as [begin, begin + count)
+static texture::rect quadSpan(
+        const msaa_data& msaa,
+        const texture::rect& area,
+        size_t& begin,
+        size_t& count
+) {
+    auto clamped = texture::intersect(area, {0, 0, int(msaa.width), int(msaa.height)});
+    if (texture::empty(clamped)) {
+        begin = count = 0;
+        return {0, 0, 0, 0};
+    }
+
+    begin = size_t(clamped.minX) & ~size_t(3);
+    count = std::min((size_t(clamped.maxX) + 3) & ~size_t(3), msaa.stride) - begin;
+    return clamped;
+}
+
+msaa_data create(size_t width, size_t height, int samples, texture::pixel_format format) {
+    assert(samples == 4 || samples == 8);
+    assert(format != texture::RGB8);
+
+    msaa_data ret;
+    ret.samples = samples;
+    ret.format  = format;
+    ret.width   = width;
+    ret.height  = height;
+    ret.stride  = texture::rowStride(width, format);
+
+    auto pixels = ret.stride * height;
+    ret.colors  = allocate<u32>(pixels * samples);
+    ret.depths  = allocate<float>(pixels * samples);
+    ret.uniform = allocate<u8>(pixels);
+
+    clear(ret, color{});
+    return ret;
+}
+
+void destroy(msaa_data& msaa) {
+    release(msaa.colors);
+    release(msaa.depths);
+    release(msaa.uniform);
+}
+
+void clear(msaa_data& msaa, const color& col, float depth) {
+    auto pixels = msaa.stride * msaa.height;
+    auto& fill  = kernels::get().fill32;
+
+    u32 depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    fill(msaa.colors, texture::pack(col, msaa.format), pixels);
+    fill(msaa.depths, depthBits, pixels);
+    std::memset(msaa.uniform, 1, pixels);
+}
+
+void clear(msaa_data& msaa, const color& col, const texture::rect& area, float depth) {
+    auto& fill = kernels::get().fill32;
+
+    u32 depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    auto packed = texture::pack(col, msaa.format);
+
+    size_t begin, count;
+    auto clamped = quadSpan(msaa, area, begin, count);
+    for (int y = clamped.minY; y < clamped.maxY; y++) {
+        auto row = y * msaa.stride + begin;
+        fill(&msaa.colors[row], packed, count);
+        fill(&msaa.depths[row], depthBits, count);
+        std::memset(&msaa.uniform[row], 1, count);
+    }
+}
+
+const vec2* samplePositions(int samples) {
+    switch (samples) {
+    case 4:
+        return positions4;
+    case 8:
+        return positions8;
+    default:
+        return positions1;
+    }
+}
+
+void expand(msaa_data& msaa, size_t idx) {
+    if (!msaa.uniform[idx]) {
+        return;
+    }
+
+    auto plane = msaa.stride * msaa.height;
+    for (int s = 1; s < msaa.samples; s++) {
+        msaa.colors[s * plane + idx] = msaa.colors[idx];
+        msaa.depths[s * plane + idx] = msaa.depths[idx];
+    }
+    msaa.uniform[idx] = 0;
+}
+
+// pixels begin to end of every plane, both multiples of 4
+static void resolveRange(const msaa_data& msaa, u32* dst, size_t begin, size_t end) {
+    auto plane = msaa.stride * msaa.height;
+    auto shift = msaa.samples == 8 ? 3 : 2;
+
+    for (size_t i = begin; i < end; i += 4) {
+        auto first = _mm_load_si128(reinterpret_cast<const __m128i*>(&msaa.colors[i]));
+
+        i32 flags;
+        std::memcpy(&flags, &msaa.uniform[i], sizeof(flags));
+        if (flags == 0x01010101) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(&dst[i]), first);
+            continue;
+        }
+
+        // widen to 16 bits so up to 8 samples can be summed per channel
+        auto lo = _mm_cvtepu8_epi16(first);
+        auto hi = _mm_cvtepu8_epi16(_mm_srli_si128(first, 8));
+        for (int s = 1; s < msaa.samples; s++) {
+            auto* src  = reinterpret_cast<const __m128i*>(&msaa.colors[s * plane + i]);
+            auto value = _mm_load_si128(src);
+            lo         = _mm_add_epi16(lo, _mm_cvtepu8_epi16(value));
+            hi         = _mm_add_epi16(hi, _mm_cvtepu8_epi16(_mm_srli_si128(value, 8)));
+        }
+        lo = _mm_srli_epi16(lo, shift);
+        hi = _mm_srli_epi16(hi, shift);
+
+        // uniform pixels in the quad have stale planes, they take plane 0 as is
+        auto average = _mm_packus_epi16(lo, hi);
+        auto uniform = _mm_cmpgt_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(flags)), _mm_setzero_si128());
+        _mm_store_si128(reinterpret_cast<__m128i*>(&dst[i]), _mm_blendv_epi8(average, first, uniform));
+    }
+}
+
+void resolve(const msaa_data& msaa, texture::texture_data& out) {
+    assert(out.type == texture::Color && out.format == msaa.format);
+    assert(out.width == msaa.width && out.height == msaa.height);
+
+    resolveRange(msaa, static_cast<u32*>(out.data), 0, msaa.stride * msaa.height);
+}
+
+void resolve(const msaa_data& msaa, texture::texture_data& out, const texture::rect& area) {
+    assert(out.type == texture::Color && out.format == msaa.format);
+    assert(out.width == msaa.width && out.height == msaa.height);
+
+    size_t begin, count;
+    auto clamped = quadSpan(msaa, area, begin, count);
+    for (int y = clamped.minY; y < clamped.maxY; y++) {
+        auto row = y * msaa.stride + begin;
+        resolveRange(msaa, static_cast<u32*>(out.data), row, row + count);
+    }
+}
+
+};// namespace sfr::msaa
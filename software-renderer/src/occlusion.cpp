@@ -0,0 +1,195 @@
+#include "occlusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace sfr::occlusion {
+
+// boxes over at most this many buffer pixels are tested pixel by pixel
+constexpr int SmallBox = 64;
+
+buffer_data create(size_t screenWidth, size_t screenHeight) {
+    buffer_data ret;
+    ret.width       = int(screenWidth + Scale - 1) / Scale;
+    ret.height      = int(screenHeight + Scale - 1) / Scale;
+    ret.stride      = (ret.width + 3) & ~3;
+    ret.blocksX     = (ret.width + BlockSize - 1) / BlockSize;
+    ret.blocksY     = (ret.height + BlockSize - 1) / BlockSize;
+    ret.blockStride = (ret.blocksX + 3) & ~3;
+    // a quad loaded at the last pixel of the last row stays inside
+    ret.depths.resize(ret.stride * ret.height + 4);
+    ret.masks.resize(ret.stride * ret.height);
+    ret.layers.resize(ret.stride * ret.height);
+    ret.blocks.resize(ret.blockStride * ret.blocksY + 4);
+    clear(ret);
+    return ret;
+}
+
+void clear(buffer_data& buffer) {
+    std::fill(buffer.depths.begin(), buffer.depths.end(), 1.f);
+    std::fill(buffer.masks.begin(), buffer.masks.end(), 0);
+    std::fill(buffer.layers.begin(), buffer.layers.end(), 0.f);
+    std::fill(buffer.blocks.begin(), buffer.blocks.end(), 1.f);
+}
+
+// Every buffer pixel the triangle touches gets the mask of the screen pixel centers it covers,
+// tested a row of 4 at a time, and the farthest depth its plane reaches over the buffer pixel.
+static void addTriangle(buffer_data& buffer, const vec3& v0, const vec3& v1, const vec3& v2) {
+    const vec3* v[3] = {&v0, &v1, &v2};
+
+    float a[3], b[3], c[3];
+    for (int i = 0; i < 3; i++) {
+        auto& from = *v[(i + 1) % 3];
+        auto& to   = *v[(i + 2) % 3];
+        a[i]       = from.y - to.y;
+        b[i]       = to.x - from.x;
+        c[i]       = (to.y - from.y) * from.x - (to.x - from.x) * from.y;
+    }
+    auto area = a[0] * v0.x + b[0] * v0.y + c[0];
+    if (area == 0.f) {
+        return;
+    }
+    auto sign = area < 0.f ? -1.f : 1.f;
+
+    // depth as zx * x + zy * y + z0, per screen pixel
+    float zx = 0.f, zy = 0.f, z0 = 0.f;
+    for (int i = 0; i < 3; i++) {
+        a[i] *= sign;
+        b[i] *= sign;
+        c[i] *= sign;
+        zx += a[i] * v[i]->z;
+        zy += b[i] * v[i]->z;
+        z0 += c[i] * v[i]->z;
+    }
+    auto invArea = 1.f / (area * sign);
+    zx *= invArea;
+    zy *= invArea;
+    z0 = z0 * invArea + (std::max(zx, 0.f) + std::max(zy, 0.f)) * Scale;
+    auto farthest = std::max({v0.z, v1.z, v2.z});
+
+    const float inv = 1.f / Scale;
+    auto minX       = std::max(0, int(std::floor(std::min({v0.x, v1.x, v2.x}) * inv)));
+    auto minY       = std::max(0, int(std::floor(std::min({v0.y, v1.y, v2.y}) * inv)));
+    auto maxX       = std::min(buffer.width - 1, int(std::floor(std::max({v0.x, v1.x, v2.x}) * inv)));
+    auto maxY       = std::min(buffer.height - 1, int(std::floor(std::max({v0.y, v1.y, v2.y}) * inv)));
+
+    __m128 edgeA[3], edgeB[3], edgeC[3];
+    for (int i = 0; i < 3; i++) {
+        edgeA[i] = _mm_set1_ps(a[i]);
+        edgeB[i] = _mm_set1_ps(b[i]);
+        edgeC[i] = _mm_set1_ps(c[i]);
+    }
+    static_assert(Scale == 4, "a row of samples is one vector");
+    auto centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            auto idx   = y * buffer.stride + x;
+            auto depth = std::min(zx * (x * Scale) + zy * (y * Scale) + z0, farthest);
+            if (depth >= buffer.depths[idx]) {
+                continue;
+            }
+
+            // samples strictly inside every edge, a center on an edge is not relied on
+            auto px   = _mm_add_ps(_mm_set1_ps(float(x * Scale)), centers);
+            int cover = 0;
+            for (int row = 0; row < Scale; row++) {
+                auto py     = _mm_set1_ps(y * Scale + row + 0.5f);
+                auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int i = 0; i < 3; i++) {
+                    auto w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[i], px), _mm_mul_ps(edgeB[i], py)), edgeC[i]);
+                    inside = _mm_and_ps(inside, _mm_cmpgt_ps(w, _mm_setzero_ps()));
+                }
+                cover |= _mm_movemask_ps(inside) << (row * Scale);
+            }
+            if (!cover) {
+                continue;
+            }
+
+            if (cover == 0xFFFF) {
+                buffer.depths[idx] = depth;
+                continue;
+            }
+            auto& mask  = buffer.masks[idx];
+            auto& layer = buffer.layers[idx];
+            mask |= u16(cover);
+            layer = std::max(layer, depth);
+            if (mask == 0xFFFF) {
+                buffer.depths[idx] = std::min(buffer.depths[idx], layer);
+                mask               = 0;
+                layer              = 0.f;
+            }
+        }
+    }
+}
+
+void addOccluders(buffer_data& buffer, const std::vector<vec3>& vertices, const std::vector<u32>& indices) {
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        addTriangle(buffer, vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]);
+    }
+}
+
+void finish(buffer_data& buffer) {
+    for (int by = 0; by < buffer.blocksY; by++) {
+        for (int bx = 0; bx < buffer.blocksX; bx++) {
+            auto farthest = 0.f;
+            auto maxY     = std::min(buffer.height, (by + 1) * BlockSize);
+            auto maxX     = std::min(buffer.width, (bx + 1) * BlockSize);
+            for (int y = by * BlockSize; y < maxY; y++) {
+                for (int x = bx * BlockSize; x < maxX; x++) {
+                    farthest = std::max(farthest, buffer.depths[y * buffer.stride + x]);
+                }
+            }
+            buffer.blocks[by * buffer.blockStride + bx] = farthest;
+        }
+    }
+}
+
+// whether any of the cells minX to maxX of rows minY to maxY lies at or behind depth
+static bool anyBehind(const float* cells, int stride, int minX, int minY, int maxX, int maxY, float depth) {
+    auto limit = _mm_set1_ps(depth);
+    for (int y = minY; y <= maxY; y++) {
+        auto* row = &cells[y * stride];
+        for (int x = minX; x <= maxX; x += 4) {
+            auto valid = (1 << std::min(4, maxX - x + 1)) - 1;
+            if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(&row[x]), limit)) & valid) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool visible(const buffer_data& buffer, const vec3& lo, const vec3& hi) {
+    // the buffer pixels the box touches, none when it is off screen
+    const float inv = 1.f / Scale;
+    auto limitX     = float(buffer.width);
+    auto limitY     = float(buffer.height);
+    auto left       = lo.x * inv;
+    auto top        = lo.y * inv;
+    auto right      = hi.x * inv;
+    auto bottom     = hi.y * inv;
+    if (!(right >= 0.f && bottom >= 0.f && left < limitX && top < limitY)) {
+        return false;
+    }
+
+    auto minX = int(std::max(left, 0.f));
+    auto minY = int(std::max(top, 0.f));
+    auto maxX = int(std::min(right, limitX - 1.f));
+    auto maxY = int(std::min(bottom, limitY - 1.f));
+    if ((maxX - minX + 1) * (maxY - minY + 1) <= SmallBox) {
+        return anyBehind(buffer.depths.data(), buffer.stride, minX, minY, maxX, maxY, lo.z);
+    }
+    return anyBehind(
+            buffer.blocks.data(),
+            buffer.blockStride,
+            minX / BlockSize,
+            minY / BlockSize,
+            maxX / BlockSize,
+            maxY / BlockSize,
+            lo.z
+    );
+}
+
+};// namespace sfr::occlusion
@@ -0,0 +1,201 @@
+#include "present.hpp"
+#include "jobs.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sfr::present {
+
+struct present_queue {
+    texture::texture_data buffers[MaxBuffers];
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<int> free;
+    std::deque<int> pending;
+    // presented, until the backend reclaims them
+    std::deque<int> retiring;
+    int current  = -1;
+    bool starved = false;
+    bool quit    = false;
+
+    std::thread thread;
+};
+
+static void presentLoop(backend sink, present_queue* queue) {
+    if (sink.attach) {
+        sink.attach(sink.user);
+    }
+
+    std::unique_lock lock(queue->mutex);
+    while (true) {
+        auto reclaimable = [queue] { return queue->starved && !queue->retiring.empty(); };
+        queue->cv.wait(lock, [&] { return queue->quit || !queue->pending.empty() || reclaimable(); });
+
+        // the renderer is blocked on a buffer, handing one back comes before presenting
+        if (reclaimable()) {
+            auto idx = queue->retiring.front();
+            queue->retiring.pop_front();
+            lock.unlock();
+            sink.reclaim(sink.user, queue->buffers[idx]);
+            lock.lock();
+
+            queue->free.push_back(idx);
+            queue->starved = false;
+            queue->cv.notify_all();
+            continue;
+        }
+        if (queue->pending.empty()) {
+            break;
+        }
+
+        auto idx = queue->pending.front();
+        lock.unlock();
+        sink.present(sink.user, queue->buffers[idx]);
+        lock.lock();
+
+        queue->pending.pop_front();
+        (sink.reclaim ? queue->retiring : queue->free).push_back(idx);
+        queue->cv.notify_all();
+    }
+    lock.unlock();
+
+    if (sink.detach) {
+        sink.detach(sink.user);
+    }
+}
+
+present_data create(
+        const backend& backend,
+        size_t width,
+        size_t height,
+        int bufferCount,
+        texture::pixel_format format
+) {
+    assert(bufferCount >= 1 && bufferCount <= MaxBuffers);
+    assert(backend.present);
+
+    present_data ret;
+    ret.sink        = backend;
+    ret.bufferCount = bufferCount;
+    ret.format      = format;
+    ret.width       = width;
+    ret.height      = height;
+    ret.queue       = new present_queue;
+
+    auto frameBytes = texture::byteSize(width, height, format);
+    for (int i = 0; i < bufferCount; i++) {
+        if (backend.storage) {
+            auto* data            = static_cast<u8*>(backend.storage) + i * frameBytes;
+            ret.queue->buffers[i] = texture::wrap(data, width, height, texture::Color, format);
+        } else {
+            ret.queue->buffers[i] = texture::create(width, height, texture::Color, format);
+        }
+        ret.queue->free.push_back(i);
+    }
+    ret.queue->thread = std::thread(presentLoop, backend, ret.queue);
+
+    return ret;
+}
+
+void destroy(present_data& present) {
+    auto* queue = present.queue;
+    {
+        std::lock_guard lock(queue->mutex);
+        queue->quit = true;
+    }
+    queue->cv.notify_all();
+    queue->thread.join();
+
+    for (int i = 0; i < present.bufferCount; i++) {
+        texture::destroy(queue->buffers[i]);
+    }
+    delete queue;
+
+    present.queue = nullptr;
+}
+
+texture::texture_data& acquire(present_data& present) {
+    auto* queue = present.queue;
+    std::unique_lock lock(queue->mutex);
+    assert(queue->current == -1);
+
+    if (queue->free.empty()) {
+        queue->starved = true;
+        queue->cv.notify_all();
+        queue->cv.wait(lock, [queue] { return !queue->free.empty(); });
+    }
+    queue->current = queue->free.front();
+    queue->free.pop_front();
+
+    return queue->buffers[queue->current];
+}
+
+void submit(present_data& present) {
+    auto* queue = present.queue;
+    {
+        std::lock_guard lock(queue->mutex);
+        assert(queue->current != -1);
+
+        queue->pending.push_back(queue->current);
+        queue->current = -1;
+    }
+    queue->cv.notify_all();
+}
+
+void flush(present_data& present) {
+    auto* queue = present.queue;
+    std::unique_lock lock(queue->mutex);
+    queue->cv.wait(lock, [queue] { return queue->pending.empty(); });
+}
+
+static void nullPresent(void* user, const texture::texture_data& frame) {
+    auto* target = static_cast<null_target*>(user);
+
+    // FNV-1a, folded over every frame so the order of presentation matters too
+    auto* bytes = static_cast<const u8*>(frame.data);
+    auto size   = texture::byteSize(frame.width, frame.height, frame.format);
+    auto hash   = target->checksum ^ 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    target->checksum = hash;
+
+    if (target->delayMicros) {
+        std::this_thread::sleep_for(std::chrono::microseconds(target->delayMicros));
+    }
+    target->frames++;
+}
+
+static void filePresent(void* user, const texture::texture_data& frame) {
+    auto* target = static_cast<file_target*>(user);
+
+    auto path = target->prefix + std::to_string(target->frames++) + ".ppm";
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+
+    // converted over the job pool, written in one go
+    std::vector<color> pixels(frame.width * frame.height);
+    jobs::parallelFor(frame.height, 16, [&](size_t begin, size_t end) {
+        for (auto y = begin; y < end; y++) {
+            texture::convertRow(frame, y, texture::RGB8, &pixels[y * frame.width]);
+        }
+    });
+    out.write(reinterpret_cast<const char*>(pixels.data()), pixels.size() * sizeof(color));
+}
+
+backend nullBackend(null_target& target) {
+    return {&target, nullptr, nullptr, nullptr, nullPresent, nullptr};
+}
+
+backend fileBackend(file_target& target) {
+    return {&target, nullptr, nullptr, nullptr, filePresent, nullptr};
+}
+
+};// namespace sfr::present
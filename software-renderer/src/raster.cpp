@@ -0,0 +1,918 @@
+#include "raster.hpp"
+#include "arena.hpp"
+#include "jobs.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <span>
+
+namespace sfr::raster {
+
+// triangles per setup job
+static const size_t SetupGrain = 1024;
+// triangles per binning job, each with a count per band
+static const size_t BinGrain = 4096;
+// segments and points per setup job
+static const size_t LineGrain  = 4096;
+static const size_t PointGrain = 4096;
+
+// One triangle of a buffer as a tile draws it, its box clipped to the tile.
+struct triangle_setup : kernels::triangle_edges {
+    int minX, minY;
+    int maxX, maxY;
+};
+
+static __m128 laneMask(int mask) {
+    return _mm_castsi128_ps(_mm_set_epi32(
+            mask & 8 ? -1 : 0,
+            mask & 4 ? -1 : 0,
+            mask & 2 ? -1 : 0,
+            mask & 1 ? -1 : 0
+    ));
+}
+
+static bool setup(
+        const vec3& v0,
+        const vec3& v1,
+        const vec3& v2,
+        const texture::rect& bounds,
+        triangle_setup& tri
+) {
+    const vec3* v[3] = {&v0, &v1, &v2};
+    for (int i = 0; i < 3; i++) {
+        auto& from = *v[(i + 1) % 3];
+        auto& to   = *v[(i + 2) % 3];
+        tri.a[i]   = from.y - to.y;
+        tri.b[i]   = to.x - from.x;
+        tri.c[i]   = (to.y - from.y) * from.x - (to.x - from.x) * from.y;
+        tri.z[i]   = v[i]->z;
+    }
+
+    // twice the signed area, triangles of either winding are made positive
+    auto area = tri.a[0] * v0.x + tri.b[0] * v0.y + tri.c[0];
+    if (area == 0.f) {
+        return false;
+    }
+    if (area < 0.f) {
+        for (int i = 0; i < 3; i++) {
+            tri.a[i] = -tri.a[i];
+            tri.b[i] = -tri.b[i];
+            tri.c[i] = -tri.c[i];
+        }
+        area = -area;
+    }
+    tri.invArea = 1.f / area;
+
+    // pixels on an edge shared by two triangles belong to exactly one of them
+    for (int i = 0; i < 3; i++) {
+        tri.topLeft[i] = tri.a[i] > 0.f || (tri.a[i] == 0.f && tri.b[i] < 0.f);
+    }
+
+    tri.minX = std::max(bounds.minX, int(std::floor(std::min({v0.x, v1.x, v2.x}))));
+    tri.minY = std::max(bounds.minY, int(std::floor(std::min({v0.y, v1.y, v2.y}))));
+    tri.maxX = std::min(bounds.maxX - 1, int(std::ceil(std::max({v0.x, v1.x, v2.x}))));
+    tri.maxY = std::min(bounds.maxY - 1, int(std::ceil(std::max({v0.y, v1.y, v2.y}))));
+    return tri.minX <= tri.maxX && tri.minY <= tri.maxY;
+}
+
+// Calls draw(t, tri) for the triangles t of the buffer reaching bounds in buffer order, from the
+// bin of the band bounds lies in when there is one and four boxes at a time otherwise.
+template <typename Draw>
+static void forEachTriangle(const triangle_buffer& triangles, const texture::rect& bounds, Draw&& draw) {
+    auto visit = [&](size_t t) {
+        triangle_setup tri;
+        static_cast<kernels::triangle_edges&>(tri) = triangles.edges[t];
+        tri.minX = std::max(bounds.minX, triangles.minX[t]);
+        tri.minY = std::max(bounds.minY, triangles.minY[t]);
+        tri.maxX = std::min(bounds.maxX - 1, triangles.maxX[t]);
+        tri.maxY = std::min(bounds.maxY - 1, triangles.maxY[t]);
+        if (tri.minX <= tri.maxX && tri.minY <= tri.maxY) {
+            draw(t, tri);
+        }
+    };
+
+    if (triangles.binRows > 0 && bounds.minY >= 0 && bounds.minY < bounds.maxY) {
+        auto band = size_t(bounds.minY / triangles.binRows);
+        if (band == size_t((bounds.maxY - 1) / triangles.binRows) && band + 1 < triangles.binStarts.size()) {
+            for (auto k = triangles.binStarts[band]; k < triangles.binStarts[band + 1]; k++) {
+                visit(triangles.binned[k]);
+            }
+            return;
+        }
+    }
+
+    auto loX = _mm_set1_epi32(bounds.minX), hiX = _mm_set1_epi32(bounds.maxX - 1);
+    auto loY = _mm_set1_epi32(bounds.minY), hiY = _mm_set1_epi32(bounds.maxY - 1);
+    auto count = triangles.index.size();
+
+    for (size_t quad = 0; quad < count; quad += 4) {
+        auto load = [&](const std::vector<int>& field) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(&field[quad]));
+        };
+        auto miss = _mm_or_si128(
+                _mm_or_si128(_mm_cmpgt_epi32(load(triangles.minX), hiX), _mm_cmplt_epi32(load(triangles.maxX), loX)),
+                _mm_or_si128(_mm_cmpgt_epi32(load(triangles.minY), hiY), _mm_cmplt_epi32(load(triangles.maxY), loY))
+        );
+
+        for (auto hits = ~_mm_movemask_ps(_mm_castsi128_ps(miss)) & 0xF; hits; hits &= hits - 1) {
+            visit(quad + __builtin_ctz(hits));
+        }
+    }
+}
+
+static texture::rect targetBounds(const target_data& target) {
+    auto width  = int(target.msaa ? target.msaa->width : target.color->width);
+    auto height = int(target.msaa ? target.msaa->height : target.color->height);
+    return texture::intersect(target.scissor, {0, 0, width, height});
+}
+
+// Calls row(y, minX, maxX, covered) over the spans of tri that can hold its pixels, covered when
+// all of the span is inside.
+template <typename Row>
+static void traverse(const triangle_setup& tri, Row&& row) {
+    if ((tri.maxX - tri.minX + 1) * (tri.maxY - tri.minY + 1) < LargeTriangle) {
+        for (int y = tri.minY; y <= tri.maxY; y++) {
+            row(y, tri.minX, tri.maxX, false);
+        }
+        return;
+    }
+
+    // edge functions are linear, their extremes over a block are at its corner pixel centers.
+    // Blocks are only trusted inside or outside by more than what rounding the kernels' sums,
+    // and these, can be off by.
+    float margin[3];
+    auto extentX = std::max(std::abs(float(tri.minX)), std::abs(tri.maxX + 1.f));
+    auto extentY = std::max(std::abs(float(tri.minY)), std::abs(tri.maxY + 1.f));
+    for (int i = 0; i < 3; i++) {
+        margin[i] = (std::abs(tri.a[i]) * extentX + std::abs(tri.b[i]) * extentY + std::abs(tri.c[i])) * 1e-6f;
+    }
+
+    enum block_class { Outside, Partial, Covered };
+    auto classify = [&](int minX, int minY, int maxX, int maxY) {
+        auto ret = Covered;
+        for (int i = 0; i < 3; i++) {
+            auto loX = minX + 0.5f, hiX = maxX + 0.5f;
+            auto loY = minY + 0.5f, hiY = maxY + 0.5f;
+            auto lo  = tri.a[i] * (tri.a[i] > 0.f ? loX : hiX) + tri.b[i] * (tri.b[i] > 0.f ? loY : hiY) + tri.c[i];
+            auto hi  = tri.a[i] * (tri.a[i] > 0.f ? hiX : loX) + tri.b[i] * (tri.b[i] > 0.f ? hiY : loY) + tri.c[i];
+            if (hi < -margin[i]) {
+                return Outside;
+            }
+            if (lo <= margin[i]) {
+                ret = Partial;
+            }
+        }
+        return ret;
+    };
+
+    // blocks on the screen grid, runs of the same class along a block row go out as one span
+    for (int blockY = tri.minY & ~(BlockSize - 1); blockY <= tri.maxY; blockY += BlockSize) {
+        auto minY = std::max(blockY, tri.minY);
+        auto maxY = std::min(blockY + BlockSize - 1, tri.maxY);
+
+        auto runClass = Outside;
+        auto runMinX  = tri.minX;
+        auto flush    = [&](int runMaxX) {
+            if (runClass == Outside) {
+                return;
+            }
+            for (int y = minY; y <= maxY; y++) {
+                row(y, runMinX, runMaxX, runClass == Covered);
+            }
+        };
+
+        for (int blockX = tri.minX & ~(BlockSize - 1); blockX <= tri.maxX; blockX += BlockSize) {
+            auto minX  = std::max(blockX, tri.minX);
+            auto maxX  = std::min(blockX + BlockSize - 1, tri.maxX);
+            auto which = classify(minX, minY, maxX, maxY);
+            if (which != runClass) {
+                flush(minX - 1);
+                runClass = which;
+                runMinX  = minX;
+            }
+        }
+        flush(tri.maxX);
+    }
+}
+
+static __m128 coverage(const triangle_setup& tri, __m128 x, __m128 y, __m128 w[3]) {
+    auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int i = 0; i < 3; i++) {
+        w[i] = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.a[i]), x), _mm_mul_ps(_mm_set1_ps(tri.b[i]), y)),
+                _mm_set1_ps(tri.c[i])
+        );
+
+        auto edge = _mm_cmpgt_ps(w[i], _mm_setzero_ps());
+        if (tri.topLeft[i]) {
+            edge = _mm_or_ps(edge, _mm_cmpeq_ps(w[i], _mm_setzero_ps()));
+        }
+        inside = _mm_and_ps(inside, edge);
+    }
+    return inside;
+}
+
+static __m128 interpolateDepth(const triangle_setup& tri, const __m128 w[3]) {
+    auto z = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(w[0], _mm_set1_ps(tri.z[0])), _mm_mul_ps(w[1], _mm_set1_ps(tri.z[1]))),
+            _mm_mul_ps(w[2], _mm_set1_ps(tri.z[2]))
+    );
+    return _mm_mul_ps(z, _mm_set1_ps(tri.invArea));
+}
+
+static float depthAt(const triangle_setup& tri, float x, float y) {
+    float z = 0.f;
+    for (int i = 0; i < 3; i++) {
+        z += (tri.a[i] * x + tri.b[i] * y + tri.c[i]) * tri.z[i];
+    }
+    return z * tri.invArea;
+}
+
+static void drawSingle(target_data& target, const triangle_setup& tri, const color& col, bool equal) {
+    auto& depthTex = *target.depth;
+    auto* depths   = static_cast<float*>(depthTex.data);
+
+    // packed targets go through the row kernel of the best instruction set
+    if (target.color->format != texture::RGB8) {
+        auto& kernels = kernels::get();
+        auto packed   = texture::pack(col, target.color->format);
+        auto* colors  = static_cast<u32*>(target.color->data);
+        traverse(tri, [&](int y, int minX, int maxX, bool covered) {
+            (covered ? kernels.fillCovered : kernels.fillRow)(
+                    tri,
+                    y,
+                    minX,
+                    maxX,
+                    &depths[y * depthTex.stride],
+                    &colors[y * target.color->stride],
+                    packed,
+                    equal
+            );
+        });
+        return;
+    }
+
+    auto lo        = _mm_set1_ps(float(tri.minX));
+    auto hi        = _mm_set1_ps(float(tri.maxX + 1));
+    auto centers   = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (int y = tri.minY; y <= tri.maxY; y++) {
+        auto py = _mm_set1_ps(y + 0.5f);
+        for (int quadX = tri.minX & ~3; quadX <= tri.maxX; quadX += 4) {
+            auto px = _mm_add_ps(_mm_set1_ps(float(quadX)), centers);
+
+            // lanes outside the bounds, the row padding and the scissor, are masked off
+            __m128 w[3];
+            auto inBounds = _mm_and_ps(_mm_cmpgt_ps(px, lo), _mm_cmplt_ps(px, hi));
+            auto inside   = _mm_and_ps(coverage(tri, px, py, w), inBounds);
+            if (!_mm_movemask_ps(inside)) {
+                continue;
+            }
+
+            auto* quad = &depths[y * depthTex.stride + quadX];
+            auto depth = interpolateDepth(tri, w);
+            auto old   = _mm_load_ps(quad);
+            auto pass  = _mm_and_ps(inside, _mm_cmpge_ps(old, depth));
+            auto mask  = _mm_movemask_ps(pass);
+            if (!mask) {
+                continue;
+            }
+
+            _mm_store_ps(quad, _mm_blendv_ps(old, depth, pass));
+            texture::setPixels(*target.color, quadX, y, mask, col);
+        }
+    }
+}
+
+static void drawMultisampled(target_data& target, const triangle_setup& tri, const color& col) {
+    auto& msaa      = *target.msaa;
+    auto plane      = msaa.stride * msaa.height;
+    auto* positions = msaa::samplePositions(msaa.samples);
+    auto allSamples = (1 << msaa.samples) - 1;
+    auto packed     = texture::pack(col, msaa.format);
+    auto lo         = _mm_set1_ps(float(tri.minX));
+    auto hi         = _mm_set1_ps(float(tri.maxX + 1));
+    auto centers    = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (int y = tri.minY; y <= tri.maxY; y++) {
+        auto py = _mm_set1_ps(y + 0.5f);
+        for (int quadX = tri.minX & ~3; quadX <= tri.maxX; quadX += 4) {
+            auto px       = _mm_add_ps(_mm_set1_ps(float(quadX)), centers);
+            auto inBounds = _mm_and_ps(_mm_cmpgt_ps(px, lo), _mm_cmplt_ps(px, hi));
+
+            // per lane bitmask of the samples inside the triangle
+            int covered[4] = {};
+            __m128 w[3];
+            for (int s = 0; s < msaa.samples; s++) {
+                auto sx     = _mm_add_ps(px, _mm_set1_ps(positions[s].x));
+                auto sy     = _mm_add_ps(py, _mm_set1_ps(positions[s].y));
+                auto inside = _mm_movemask_ps(_mm_and_ps(coverage(tri, sx, sy, w), inBounds));
+                for (int lane = 0; lane < 4; lane++) {
+                    covered[lane] |= ((inside >> lane) & 1) << s;
+                }
+            }
+
+            int anyMask = 0, fullMask = 0;
+            for (int lane = 0; lane < 4; lane++) {
+                anyMask |= (covered[lane] != 0) << lane;
+                fullMask |= (covered[lane] == allSamples) << lane;
+            }
+            if (!anyMask) {
+                continue;
+            }
+
+            auto idx = y * msaa.stride + quadX;
+            coverage(tri, px, py, w);
+            auto center = interpolateDepth(tri, w);
+
+            // fully covered lanes of uniform pixels stay compressed, shaded and tested once
+            int uniformMask = 0;
+            for (int lane = 0; lane < 4; lane++) {
+                uniformMask |= (msaa.uniform[idx + lane] != 0) << lane;
+            }
+            auto fastMask = fullMask & uniformMask;
+            if (fastMask) {
+                auto* colors = reinterpret_cast<__m128i*>(&msaa.colors[idx]);
+                auto old     = _mm_load_ps(&msaa.depths[idx]);
+                auto pass    = _mm_and_ps(laneMask(fastMask), _mm_cmpge_ps(old, center));
+
+                _mm_store_ps(&msaa.depths[idx], _mm_blendv_ps(old, center, pass));
+                _mm_store_si128(
+                        colors,
+                        _mm_blendv_epi8(
+                                _mm_load_si128(colors),
+                                _mm_set1_epi32(packed),
+                                _mm_castps_si128(pass)
+                        )
+                );
+            }
+
+            // edge pixels, and pixels already holding several values, go sample by sample
+            auto slowMask = anyMask & ~fastMask;
+            alignas(16) float centerDepths[4];
+            _mm_store_ps(centerDepths, center);
+            for (int lane = 0; lane < 4; lane++) {
+                if (!(slowMask & (1 << lane))) {
+                    continue;
+                }
+
+                auto pixel = idx + lane;
+                msaa::expand(msaa, pixel);
+
+                int passed = 0;
+                for (int s = 0; s < msaa.samples; s++) {
+                    if (!(covered[lane] & (1 << s))) {
+                        continue;
+                    }
+
+                    auto x     = quadX + lane + 0.5f + positions[s].x;
+                    auto depth = depthAt(tri, x, y + 0.5f + positions[s].y);
+                    auto& old  = msaa.depths[s * plane + pixel];
+                    if (old >= depth) {
+                        old                          = depth;
+                        msaa.colors[s * plane + pixel] = packed;
+                        passed++;
+                    }
+                }
+
+                if (passed == msaa.samples) {
+                    msaa.depths[pixel]  = centerDepths[lane];
+                    msaa.uniform[pixel] = 1;
+                }
+            }
+        }
+    }
+}
+
+void setupTriangles(
+        triangle_buffer& ret,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+) {
+    auto count = indices.size() / 3;
+    ret.binRows = 0;
+    ret.minX.resize(count);
+    ret.minY.resize(count);
+    ret.maxX.resize(count);
+    ret.maxY.resize(count);
+    ret.edges.resize(count);
+    ret.index.resize(count);
+
+    // every range packs the triangles it keeps at its start
+    auto& scratch = arena::local();
+    auto start    = arena::mark(scratch);
+    auto kept     = arena::allocate<size_t>(scratch, (count + SetupGrain - 1) / SetupGrain);
+    jobs::parallelFor(count, SetupGrain, [&](size_t begin, size_t end) {
+        auto out = begin;
+        for (size_t t = begin; t < end; t++) {
+            triangle_setup tri;
+            auto* corners = &indices[t * 3];
+            if (!setup(vertices[corners[0]], vertices[corners[1]], vertices[corners[2]], bounds, tri)) {
+                continue;
+            }
+
+            ret.minX[out]  = tri.minX;
+            ret.minY[out]  = tri.minY;
+            ret.maxX[out]  = tri.maxX;
+            ret.maxY[out]  = tri.maxY;
+            ret.edges[out] = tri;
+            ret.index[out] = u32(t);
+            out++;
+        }
+        kept[begin / SetupGrain] = out - begin;
+    });
+
+    // then move down over the dropped ones in order, each range only overwrites ones already moved
+    size_t size = 0;
+    for (size_t range = 0; range < kept.size(); range++) {
+        auto from = range * SetupGrain;
+        if (from != size) {
+            auto move = [&](auto& field) {
+                std::copy(field.begin() + from, field.begin() + from + kept[range], field.begin() + size);
+            };
+            move(ret.minX);
+            move(ret.minY);
+            move(ret.maxX);
+            move(ret.maxY);
+            move(ret.edges);
+            move(ret.index);
+        }
+        size += kept[range];
+    }
+    arena::rewind(scratch, start);
+
+    // boxes that never reach anything pad the quads
+    auto quads = (size + 3) & ~size_t(3);
+    ret.minX.resize(quads);
+    ret.minY.resize(quads);
+    ret.maxX.resize(quads);
+    ret.maxY.resize(quads);
+    for (auto t = size; t < quads; t++) {
+        ret.minX[t] = ret.minY[t] = std::numeric_limits<int>::max();
+        ret.maxX[t] = ret.maxY[t] = std::numeric_limits<int>::min();
+    }
+    ret.edges.resize(size);
+    ret.index.resize(size);
+}
+
+triangle_buffer setupTriangles(
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+) {
+    triangle_buffer ret;
+    setupTriangles(ret, vertices, indices, bounds);
+    return ret;
+}
+
+void binTriangles(triangle_buffer& triangles, int rows, int height) {
+    assert(rows > 0);
+
+    auto count   = triangles.index.size();
+    auto bands   = size_t(std::max(0, (height + rows - 1) / rows));
+    auto ranges  = (count + BinGrain - 1) / BinGrain;
+    auto bandsOf = [&](size_t t, size_t& first, size_t& last) {
+        first = size_t(std::max(0, triangles.minY[t]) / rows);
+        last  = std::min(size_t(std::max(0, triangles.maxY[t]) / rows), bands - 1);
+    };
+
+    // every range counts what it puts in each band, then gets its own slots in every bin right
+    // after those of the ranges before it, so the bins hold the triangles in buffer order
+    triangles.binRows = 0;
+    triangles.binStarts.clear();
+    triangles.binned.clear();
+    if (!bands) {
+        return;
+    }
+    // the caller's scratch, the ranges take their own below
+    auto& local = arena::local();
+    auto entry  = arena::mark(local);
+    auto slots  = arena::allocate<u32>(local, ranges * bands);
+
+    // ranges next to each other share cache lines in slots, they count and fill through copies
+    jobs::parallelFor(count, BinGrain, [&](size_t begin, size_t end) {
+        auto& scratch = arena::local();
+        auto start    = arena::mark(scratch);
+        auto counts   = arena::allocate<u32>(scratch, bands);
+        for (auto t = begin; t < end; t++) {
+            size_t first, last;
+            bandsOf(t, first, last);
+            for (auto band = first; band <= last; band++) {
+                counts[band]++;
+            }
+        }
+        std::copy(counts.begin(), counts.end(), slots.begin() + begin / BinGrain * bands);
+        arena::rewind(scratch, start);
+    });
+
+    triangles.binStarts.resize(bands + 1);
+    u32 total = 0;
+    for (size_t band = 0; band < bands; band++) {
+        triangles.binStarts[band] = total;
+        for (size_t range = 0; range < ranges; range++) {
+            auto& slot = slots[range * bands + band];
+            auto size  = slot;
+            slot       = total;
+            total += size;
+        }
+    }
+    triangles.binStarts[bands] = total;
+
+    triangles.binned.resize(total);
+    jobs::parallelFor(count, BinGrain, [&](size_t begin, size_t end) {
+        auto& scratch = arena::local();
+        auto start    = arena::mark(scratch);
+        auto own      = slots.begin() + begin / BinGrain * bands;
+        auto next     = arena::allocate<u32>(scratch, bands);
+        std::copy(own, own + bands, next.begin());
+        for (auto t = begin; t < end; t++) {
+            size_t first, last;
+            bandsOf(t, first, last);
+            for (auto band = first; band <= last; band++) {
+                triangles.binned[next[band]++] = u32(t);
+            }
+        }
+        arena::rewind(scratch, start);
+    });
+    arena::rewind(local, entry);
+    triangles.binRows = rows;
+}
+
+void drawTriangles(
+        target_data& target,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const std::vector<color>& colors
+) {
+    assert(target.msaa || (target.color && target.depth));
+
+    drawTriangles(target, setupTriangles(vertices, indices, targetBounds(target)), colors);
+}
+
+void drawTriangles(
+        target_data& target,
+        const triangle_buffer& triangles,
+        const std::vector<color>& colors,
+        bool equalDepth
+) {
+    assert(target.msaa || (target.color && target.depth));
+    assert(!equalDepth || (!target.msaa && target.color->format != texture::RGB8));
+
+    forEachTriangle(triangles, targetBounds(target), [&](size_t t, const triangle_setup& tri) {
+        auto& col = colors[triangles.index[t] % colors.size()];
+        if (target.msaa) {
+            drawMultisampled(target, tri, col);
+        } else {
+            drawSingle(target, tri, col, equalDepth);
+        }
+    });
+}
+
+void drawDepth(target_data& target, const triangle_buffer& triangles) {
+    assert(!target.msaa && target.depth);
+
+    auto& depthTex = *target.depth;
+    auto* depths   = static_cast<float*>(depthTex.data);
+    auto& kernels  = kernels::get();
+    auto bounds    = texture::intersect(target.scissor, {0, 0, int(depthTex.width), int(depthTex.height)});
+
+    forEachTriangle(triangles, bounds, [&](size_t, const triangle_setup& tri) {
+        traverse(tri, [&](int y, int minX, int maxX, bool covered) {
+            (covered ? kernels.depthCovered : kernels.depthRow)(tri, y, minX, maxX, &depths[y * depthTex.stride]);
+        });
+    });
+}
+
+// From the exponent bits, -ffast-math folds std::isfinite and the NaN compares away. Nothing
+// clips at w = 0 before setup, so vertices at or behind the camera can be anything.
+static bool finite(float value) {
+    return (std::bit_cast<u32>(value) & 0x7f800000u) != 0x7f800000u;
+}
+
+static bool finite(const vec3& v) {
+    return finite(v.x) && finite(v.y);
+}
+
+// Narrows first to last down to the steps landing within a pixel of bounds, false when none do.
+// start and step have to be finite, so a and b are never NaN.
+static bool clipSteps(const vec3& start, const vec3& step, const texture::rect& bounds, int& first, int& last) {
+    float lo[2] = {float(bounds.minX - 1), float(bounds.minY - 1)};
+    float hi[2] = {float(bounds.maxX + 1), float(bounds.maxY + 1)};
+    for (int c = 0; c < 2; c++) {
+        if (step[c] == 0.f) {
+            if (start[c] < lo[c] || start[c] > hi[c]) {
+                return false;
+            }
+            continue;
+        }
+
+        auto a = (lo[c] - start[c]) / step[c];
+        auto b = (hi[c] - start[c]) / step[c];
+        // clamped before the conversion, far off screen segments overflow int otherwise
+        auto limit = float(std::numeric_limits<int>::max() / 2);
+        first      = std::max(first, int(std::ceil(std::clamp(std::min(a, b), -limit, limit))));
+        last       = std::min(last, int(std::floor(std::clamp(std::max(a, b), -limit, limit))));
+    }
+    return first <= last;
+}
+
+void setupLines(
+        std::vector<line_setup>& ret,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+) {
+    auto segments = indices.size() / 2;
+    auto ranges   = (segments + LineGrain - 1) / LineGrain;
+
+    // every range clips its segments and counts their pieces, then cuts them at the offset of its
+    // first piece, so ranges write in order without sharing anything
+    auto& scratch = arena::local();
+    auto start    = arena::mark(scratch);
+    auto clipped  = arena::allocate<line_setup>(scratch, segments);
+    auto offsets  = arena::allocate<size_t>(scratch, ranges + 1);
+    jobs::parallelFor(segments, LineGrain, [&](size_t begin, size_t end) {
+        size_t pieces = 0;
+        for (auto s = begin; s < end; s++) {
+            auto& v0   = vertices[indices[s * 2]];
+            auto& v1   = vertices[indices[s * 2 + 1]];
+            auto& line = clipped[s];
+            line.index = u32(s);
+            if (!finite(v0) || !finite(v1)) {
+                line.first = 0;
+                line.last  = -1;
+                continue;
+            }
+
+            // a sample per pixel along the longer axis, at least the one of v0; the difference of
+            // far off ends can still overflow
+            auto delta = v1 - v0;
+            auto steps = std::max(std::abs(delta.x), std::abs(delta.y));
+            auto count = finite(steps) ? int(std::min(std::ceil(steps), 1e8f)) : 0;
+
+            line.start = v0;
+            line.step  = count ? delta / float(count) : vec3(0.f);
+            line.first = 0;
+            line.last  = count;
+
+            // segments with both ends inside need no clipping, the common case for overlays
+            auto inside = [&](const vec3& v) {
+                return v.x >= bounds.minX && v.x < bounds.maxX && v.y >= bounds.minY && v.y < bounds.maxY;
+            };
+            if (!(inside(v0) && inside(v1)) && !clipSteps(line.start, line.step, bounds, line.first, line.last)) {
+                line.last = line.first - 1;
+                continue;
+            }
+            pieces += size_t(line.last - line.first) / LineChunk + 1;
+        }
+        offsets[begin / LineGrain + 1] = pieces;
+    });
+    for (size_t range = 0; range < ranges; range++) {
+        offsets[range + 1] += offsets[range];
+    }
+
+    ret.resize(offsets[ranges]);
+    jobs::parallelFor(segments, LineGrain, [&](size_t begin, size_t end) {
+        auto out = offsets[begin / LineGrain];
+        for (auto s = begin; s < end; s++) {
+            auto& line = clipped[s];
+            for (auto first = line.first; first <= line.last; first += LineChunk) {
+                auto piece  = line;
+                piece.first = first;
+                piece.last  = std::min(line.last, first + LineChunk - 1);
+
+                auto from  = line.start + float(piece.first) * line.step;
+                auto to    = line.start + float(piece.last) * line.step;
+                piece.area = {
+                        int(std::floor(std::min(from.x, to.x))),
+                        int(std::floor(std::min(from.y, to.y))),
+                        int(std::floor(std::max(from.x, to.x))) + 1,
+                        int(std::floor(std::max(from.y, to.y))) + 1,
+                };
+                ret[out++] = piece;
+            }
+        }
+    });
+    arena::rewind(scratch, start);
+
+    // index and first break ties, so the order does not depend on the sort
+    std::sort(ret.begin(), ret.end(), [](const line_setup& a, const line_setup& b) {
+        if (a.area.minY != b.area.minY) {
+            return a.area.minY < b.area.minY;
+        }
+        return a.index != b.index ? a.index < b.index : a.first < b.first;
+    });
+}
+
+std::vector<line_setup> setupLines(
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const texture::rect& bounds
+) {
+    std::vector<line_setup> ret;
+    setupLines(ret, vertices, indices, bounds);
+    return ret;
+}
+
+std::vector<u32> wireframeEdges(const std::vector<u32>& indices) {
+    // both ends packed in one key, lower index first, so shared edges sort next to each other
+    std::vector<u64> keys;
+    keys.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        for (int e = 0; e < 3; e++) {
+            auto a = indices[i + e];
+            auto b = indices[i + (e + 1) % 3];
+            keys.push_back(u64(std::min(a, b)) << 32 | std::max(a, b));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<u32> ret;
+    ret.reserve(keys.size() * 2);
+    for (auto key: keys) {
+        ret.push_back(u32(key >> 32));
+        ret.push_back(u32(key));
+    }
+    return ret;
+}
+
+// Writes col at x, y when it passes the depth test, x and y already inside the target.
+static void plot(target_data& target, int x, int y, float z, u32 packed, const color& col, bool depthTest) {
+    if (depthTest) {
+        auto* depths = static_cast<const float*>(target.depth->data);
+        if (z - LineDepthBias > depths[y * target.depth->stride + x]) {
+            return;
+        }
+    }
+
+    auto& tex = *target.color;
+    if (tex.format == texture::RGB8) {
+        texture::setPixel(tex, x, y, col);
+    } else {
+        static_cast<u32*>(tex.data)[y * tex.stride + x] = packed;
+    }
+}
+
+void drawLines(
+        target_data& target,
+        const std::vector<line_setup>& lines,
+        const std::vector<color>& colors,
+        bool depthTest
+) {
+    assert(!target.msaa && target.color && (!depthTest || target.depth));
+
+    // pieces span at most LineChunk rows, the ones starting further up end above the tile
+    auto bounds = targetBounds(target);
+    auto byRow  = [](const line_setup& line, int row) { return line.area.minY < row; };
+    auto begin  = std::lower_bound(lines.begin(), lines.end(), bounds.minY - LineChunk, byRow);
+    auto end    = std::lower_bound(begin, lines.end(), bounds.maxY, byRow);
+    for (auto& line: std::span(begin, end)) {
+        auto overlap = texture::intersect(line.area, bounds);
+        if (texture::empty(overlap)) {
+            continue;
+        }
+
+        auto& col   = colors[line.index % colors.size()];
+        auto packed = texture::pack(col, target.color->format);
+        auto first  = line.first, last = line.last;
+        auto start  = line.start, step = line.step;
+
+        // the whole segment lies in the tile, every step is a pixel of it
+        if (std::memcmp(&overlap, &line.area, sizeof(overlap)) == 0) {
+            for (int i = first; i <= last; i++) {
+                auto x = start.x + float(i) * step.x;
+                auto y = start.y + float(i) * step.y;
+                plot(target, int(std::floor(x)), int(std::floor(y)), start.z + float(i) * step.z, packed, col, depthTest);
+            }
+            continue;
+        }
+
+        if (!clipSteps(start, step, bounds, first, last)) {
+            continue;
+        }
+        for (int i = first; i <= last; i++) {
+            auto x = int(std::floor(start.x + float(i) * step.x));
+            auto y = int(std::floor(start.y + float(i) * step.y));
+            if (x >= bounds.minX && x < bounds.maxX && y >= bounds.minY && y < bounds.maxY) {
+                plot(target, x, y, start.z + float(i) * step.z, packed, col, depthTest);
+            }
+        }
+    }
+}
+
+void drawLines(
+        target_data& target,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        const std::vector<color>& colors,
+        bool depthTest
+) {
+    drawLines(target, setupLines(vertices, indices, targetBounds(target)), colors, depthTest);
+}
+
+void setupPoints(
+        std::vector<point_setup>& ret,
+        const std::vector<vec3>& vertices,
+        const texture::rect& bounds,
+        int size
+) {
+    auto count = vertices.size();
+    ret.resize(count);
+
+    // every range packs the points it keeps at its start, then they move down in order
+    auto& scratch = arena::local();
+    auto start    = arena::mark(scratch);
+    auto kept     = arena::allocate<size_t>(scratch, (count + PointGrain - 1) / PointGrain);
+    jobs::parallelFor(count, PointGrain, [&](size_t begin, size_t end) {
+        auto out   = begin;
+        auto limit = float(1 << 30);
+        for (auto i = begin; i < end; i++) {
+            auto& v = vertices[i];
+            if (!finite(v) || std::abs(v.x) >= limit || std::abs(v.y) >= limit) {
+                continue;
+            }
+
+            // the size x size pixels whose centers are nearest to v
+            auto minX = int(std::floor(v.x - 0.5f * size + 0.5f));
+            auto minY = int(std::floor(v.y - 0.5f * size + 0.5f));
+            auto area = texture::intersect(bounds, {minX, minY, minX + size, minY + size});
+            if (!texture::empty(area)) {
+                ret[out++] = {area, v.z, u32(i)};
+            }
+        }
+        kept[begin / PointGrain] = out - begin;
+    });
+
+    size_t total = 0;
+    for (size_t range = 0; range < kept.size(); range++) {
+        auto from = ret.begin() + range * PointGrain;
+        std::copy(from, from + kept[range], ret.begin() + total);
+        total += kept[range];
+    }
+    ret.resize(total);
+    arena::rewind(scratch, start);
+
+    // every point is size rows high before clipping, so both the first and the last row grow along
+    // the sorted points
+    std::sort(ret.begin(), ret.end(), [](const point_setup& a, const point_setup& b) {
+        if (a.area.minY != b.area.minY) {
+            return a.area.minY < b.area.minY;
+        }
+        return a.area.maxY != b.area.maxY ? a.area.maxY < b.area.maxY : a.index < b.index;
+    });
+}
+
+std::vector<point_setup> setupPoints(const std::vector<vec3>& vertices, const texture::rect& bounds, int size) {
+    std::vector<point_setup> ret;
+    setupPoints(ret, vertices, bounds, size);
+    return ret;
+}
+
+void drawPoints(
+        target_data& target,
+        const std::vector<point_setup>& points,
+        const std::vector<color>& colors,
+        bool depthTest
+) {
+    assert(!target.msaa && target.color && (!depthTest || target.depth));
+
+    auto bounds = targetBounds(target);
+    auto begin  = std::partition_point(points.begin(), points.end(), [&](const point_setup& point) {
+        return point.area.maxY <= bounds.minY;
+    });
+    auto end = std::partition_point(begin, points.end(), [&](const point_setup& point) {
+        return point.area.minY < bounds.maxY;
+    });
+    for (auto& point: std::span(begin, end)) {
+        auto area = texture::intersect(bounds, point.area);
+        if (texture::empty(area)) {
+            continue;
+        }
+
+        auto& col   = colors[point.index % colors.size()];
+        auto packed = texture::pack(col, target.color->format);
+        for (int y = area.minY; y < area.maxY; y++) {
+            for (int x = area.minX; x < area.maxX; x++) {
+                plot(target, x, y, point.depth, packed, col, depthTest);
+            }
+        }
+    }
+}
+
+void drawPoints(
+        target_data& target,
+        const std::vector<vec3>& vertices,
+        const std::vector<color>& colors,
+        int size,
+        bool depthTest
+) {
+    drawPoints(target, setupPoints(vertices, targetBounds(target), size), colors, depthTest);
+}
+
+};// namespace sfr::raster
@@ -0,0 +1,401 @@
+#include "shadow.hpp"
+#include "jobs.hpp"
+#include "kernels.hpp"
+#include "raster.hpp"
+#include "math/transform.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace sfr::shadow {
+
+// between even (0) and logarithmic (1) spacing of the cascade splits
+constexpr float SplitBlend = 0.75f;
+
+// the screen to map matrix of every cascade, for one apply call
+struct lookup_data {
+    const shadow_data* shadow;
+    mat4 screenToMap[MaxCascades];
+};
+
+static __m128i laneMask(int mask) {
+    return _mm_set_epi32(
+            mask & 8 ? -1 : 0,
+            mask & 4 ? -1 : 0,
+            mask & 2 ? -1 : 0,
+            mask & 1 ? -1 : 0
+    );
+}
+
+static vec3 cross(const vec3& u, const vec3& v) {
+    return vec3(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+}
+
+// rows right, up and back, so light space z grows towards the light
+static mat4 lightView(const vec3& direction) {
+    auto back  = normalize(-1.f * direction);
+    auto up    = std::abs(back.y) < 0.99f ? vec3(0.f, 1.f, 0.f) : vec3(1.f, 0.f, 0.f);
+    auto right = normalize(cross(up, back));
+    return view(vec3(0.f), back, right, cross(back, right));
+}
+
+// of a point distance units in front of the camera, for the perspective() of zNear and zFar
+static float screenDepth(float distance, float zNear, float zFar) {
+    return ((zFar + zNear) - 2.f * zFar * zNear / distance) / (zFar - zNear);
+}
+
+static void transformPoints(const mat4& m, const std::vector<vec3>& in, std::vector<vec3>& out) {
+    out.resize(in.size());
+    if (!in.empty()) {
+        kernels::get().transformPoints(&m[0][0], &in[0].x, &out[0].x, in.size(), false, precision::exact);
+    }
+}
+
+// the same offset for the whole triangle, grown with how steeply its depth changes across the map
+static void applyBias(const shadow_data& shadow, kernels::triangle_edges& tri) {
+    float dx = 0.f, dy = 0.f;
+    for (int i = 0; i < 3; i++) {
+        dx += tri.a[i] * tri.z[i];
+        dy += tri.b[i] * tri.z[i];
+    }
+    auto slope = std::max(std::abs(dx), std::abs(dy)) * tri.invArea;
+    auto bias  = shadow.constantBias + shadow.slopeBias * slope;
+    for (auto& z: tri.z) {
+        z += bias;
+    }
+}
+
+static void renderCascade(
+        shadow_data& shadow,
+        int index,
+        const mat4& light,
+        const mat4& cameraInverse,
+        float nearDepth,
+        float farDepth,
+        float casterMinZ,
+        float casterMaxZ,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices
+) {
+    auto& cascade = shadow.cascades[index];
+    auto& map     = cascade.depth;
+
+    // the corners of the slice in light space
+    auto lo = vec3(std::numeric_limits<float>::max());
+    auto hi = vec3(-std::numeric_limits<float>::max());
+    for (int i = 0; i < 8; i++) {
+        auto corner = vec4(i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f, i & 4 ? farDepth : nearDepth, 1.f);
+        auto world  = cameraInverse * corner;
+        auto point  = light * vec4(world.x / world.w, world.y / world.w, world.z / world.w, 1.f);
+        for (int c = 0; c < 3; c++) {
+            lo[c] = std::min(lo[c], point[c]);
+            hi[c] = std::max(hi[c], point[c]);
+        }
+    }
+    // casters outside the slice still shadow it
+    lo.z = std::min(lo.z, casterMinZ);
+    hi.z = std::max(hi.z, casterMaxZ);
+
+    auto scaleX = float(map.width) / std::max(hi.x - lo.x, 1e-6f);
+    auto scaleY = float(map.height) / std::max(hi.y - lo.y, 1e-6f);
+    auto scaleZ = 1.f / std::max(hi.z - lo.z, 1e-6f);
+    auto toMap  = mat4(1.f);
+    toMap[0][0] = scaleX;
+    toMap[1][1] = scaleY;
+    toMap[2][2] = -scaleZ;
+    toMap[3][0] = -lo.x * scaleX;
+    toMap[3][1] = -lo.y * scaleY;
+    toMap[3][2] = hi.z * scaleZ;
+
+    cascade.worldToMap = toMap * light;
+    cascade.splitDepth = farDepth;
+
+    transformPoints(cascade.worldToMap, vertices, cascade.vertices);
+    raster::setupTriangles(cascade.triangles, cascade.vertices, indices, {0, 0, int(map.width), int(map.height)});
+    for (auto& tri: cascade.triangles.edges) {
+        applyBias(shadow, tri);
+    }
+
+    texture::clear(map, vec3(1.f));
+    raster::target_data target{nullptr, &map, nullptr};
+    raster::drawDepth(target, cascade.triangles);
+}
+
+shadow_data create(size_t mapSize, int cascadeCount, const vec3& direction) {
+    assert(cascadeCount > 0 && cascadeCount <= MaxCascades);
+    assert(mapSize >= 4);
+
+    shadow_data ret;
+    ret.direction    = normalize(direction);
+    ret.constantBias = 0.002f;
+    ret.slopeBias    = 1.5f;
+    ret.ambient      = 0.4f;
+    ret.cascades.resize(cascadeCount);
+    for (auto& cascade: ret.cascades) {
+        cascade.depth      = texture::create(mapSize, mapSize, texture::Depth);
+        cascade.worldToMap = mat4(1.f);
+        cascade.splitDepth = -1.f;
+    }
+    return ret;
+}
+
+void destroy(shadow_data& shadow) {
+    for (auto& cascade: shadow.cascades) {
+        texture::destroy(cascade.depth);
+    }
+    shadow.cascades.clear();
+}
+
+void render(
+        shadow_data& shadow,
+        const mat4& viewProjection,
+        float zNear,
+        float zFar,
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices
+) {
+    auto light = lightView(shadow.direction);
+
+    // only the depth of the casters along the light is needed
+    auto casterMinZ = std::numeric_limits<float>::max();
+    auto casterMaxZ = -std::numeric_limits<float>::max();
+    for (auto& v: vertices) {
+        auto z     = light[0][2] * v.x + light[1][2] * v.y + light[2][2] * v.z + light[3][2];
+        casterMinZ = std::min(casterMinZ, z);
+        casterMaxZ = std::max(casterMaxZ, z);
+    }
+
+    auto count = int(shadow.cascades.size());
+    float splits[MaxCascades + 1];
+    for (int i = 0; i <= count; i++) {
+        auto t         = float(i) / float(count);
+        auto even      = zNear + (zFar - zNear) * t;
+        auto logarithm = zNear * std::pow(zFar / zNear, t);
+        splits[i]      = screenDepth(even + (logarithm - even) * SplitBlend, zNear, zFar);
+    }
+
+    auto cameraInverse = inverse(viewProjection);
+    jobs::parallelFor(count, 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            renderCascade(
+                    shadow,
+                    int(i),
+                    light,
+                    cameraInverse,
+                    splits[i],
+                    splits[i + 1],
+                    casterMinZ,
+                    casterMaxZ,
+                    vertices,
+                    indices
+            );
+        }
+    });
+}
+
+// Share of the 4x4 texels around map position x, y the depth is lit by, for the lanes in lanes,
+// positions off the map lit. Every row of 4 is one compare, the counts add up as vectors and the
+// lanes are summed together at the end.
+static __m128 visibility(const cascade_data& cascade, __m128 x, __m128 y, __m128 depth, int lanes) {
+    auto& map   = cascade.depth;
+    auto width  = _mm_set1_ps(float(map.width));
+    auto height = _mm_set1_ps(float(map.height));
+    auto zero   = _mm_setzero_ps();
+    auto onMap  = _mm_and_ps(
+            _mm_and_ps(_mm_cmpge_ps(x, zero), _mm_cmpge_ps(y, zero)),
+            _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(x, width), _mm_cmplt_ps(y, height)), _mm_cmple_ps(depth, _mm_set1_ps(1.f)))
+    );
+    lanes &= _mm_movemask_ps(onMap);
+
+    auto half  = _mm_set1_ps(0.5f);
+    auto one   = _mm_set1_epi32(1);
+    auto left  = _mm_sub_epi32(_mm_cvttps_epi32(_mm_sub_ps(x, half)), one);
+    auto top   = _mm_sub_epi32(_mm_cvttps_epi32(_mm_sub_ps(y, half)), one);
+    left       = _mm_max_epi32(_mm_min_epi32(left, _mm_set1_epi32(int(map.width) - 4)), _mm_setzero_si128());
+    top        = _mm_max_epi32(_mm_min_epi32(top, _mm_set1_epi32(int(map.height) - 4)), _mm_setzero_si128());
+    auto start = _mm_add_epi32(_mm_mullo_epi32(top, _mm_set1_epi32(int(map.stride))), left);
+
+    alignas(16) int starts[4];
+    alignas(16) float depths[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(starts), start);
+    _mm_store_ps(depths, depth);
+
+    // the compares are -1 where lit, lanes off the map count all 16 texels
+    auto* texels = static_cast<const float*>(map.data);
+    __m128i counts[4];
+    for (int lane = 0; lane < 4; lane++) {
+        if (!(lanes & (1 << lane))) {
+            counts[lane] = _mm_set1_epi32(-4);
+            continue;
+        }
+        auto sample = _mm_set1_ps(depths[lane]);
+        auto* row   = &texels[starts[lane]];
+        auto count  = _mm_setzero_si128();
+        for (int r = 0; r < 4; r++) {
+            count = _mm_add_epi32(count, _mm_castps_si128(_mm_cmple_ps(sample, _mm_loadu_ps(&row[r * map.stride]))));
+        }
+        counts[lane] = count;
+    }
+    auto lit = _mm_hadd_epi32(_mm_hadd_epi32(counts[0], counts[1]), _mm_hadd_epi32(counts[2], counts[3]));
+    return _mm_mul_ps(_mm_cvtepi32_ps(lit), _mm_set1_ps(-1.f / 16.f));
+}
+
+// each channel times factor / 256, alpha kept
+static __m128i darken(__m128i pixels, __m128i factors) {
+    auto halves = _mm_packus_epi32(factors, factors);
+    auto pairs  = _mm_unpacklo_epi16(halves, halves);
+    auto alpha  = _mm_set1_epi16(256);
+    auto lo     = _mm_blend_epi16(_mm_unpacklo_epi32(pairs, pairs), alpha, 0x88);
+    auto hi     = _mm_blend_epi16(_mm_unpackhi_epi32(pairs, pairs), alpha, 0x88);
+
+    auto zero = _mm_setzero_si128();
+    auto a    = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), lo), 8);
+    auto b    = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), hi), 8);
+    return _mm_packus_epi16(a, b);
+}
+
+// Pixels minX to maxX of row y. Pixels flagged in skip, when given, are left alone.
+static void applyRow(
+        const lookup_data& lookup,
+        int y,
+        int minX,
+        int maxX,
+        const float* depths,
+        u32* colors,
+        const u8* skip
+) {
+    auto& shadow = *lookup.shadow;
+    auto count   = int(shadow.cascades.size());
+    auto py      = _mm_set1_ps(y + 0.5f);
+    auto lo      = _mm_set1_ps(float(minX));
+    auto hi      = _mm_set1_ps(float(maxX + 1));
+    auto centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (int x = minX & ~3; x <= maxX; x += 4) {
+        auto px    = _mm_add_ps(_mm_set1_ps(float(x)), centers);
+        auto depth = _mm_load_ps(&depths[x]);
+        // cleared pixels hold no surface to shadow
+        auto valid = _mm_and_ps(_mm_cmpgt_ps(px, lo), _mm_cmplt_ps(px, hi));
+        auto mask  = _mm_movemask_ps(_mm_and_ps(valid, _mm_cmplt_ps(depth, _mm_set1_ps(1.f))));
+        if (skip) {
+            for (int lane = 0; lane < 4; lane++) {
+                mask &= skip[x + lane] ? ~(1 << lane) : ~0;
+            }
+        }
+        if (!mask) {
+            continue;
+        }
+
+        auto factors   = _mm_set1_epi32(256);
+        auto remaining = mask;
+        for (int c = 0; c < count && remaining; c++) {
+            auto split  = _mm_set1_ps(shadow.cascades[c].splitDepth);
+            auto inside = remaining & _mm_movemask_ps(_mm_cmple_ps(depth, split));
+            if (!inside) {
+                continue;
+            }
+            remaining &= ~inside;
+
+            auto& m  = lookup.screenToMap[c];
+            auto row = [&](int r) {
+                return _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0][r]), px), _mm_mul_ps(_mm_set1_ps(m[1][r]), py)),
+                        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[2][r]), depth), _mm_set1_ps(m[3][r]))
+                );
+            };
+            auto invW = _mm_div_ps(_mm_set1_ps(1.f), row(3));
+            auto lit  = visibility(
+                    shadow.cascades[c],
+                    _mm_mul_ps(row(0), invW),
+                    _mm_mul_ps(row(1), invW),
+                    _mm_mul_ps(row(2), invW),
+                    inside
+            );
+
+            // 256 * (ambient + (1 - ambient) * lit), rounded
+            auto ambient = _mm_set1_ps(shadow.ambient);
+            auto light   = _mm_add_ps(ambient, _mm_mul_ps(_mm_set1_ps(1.f - shadow.ambient), lit));
+            auto scaled  = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(256.f), light), _mm_set1_ps(0.5f)));
+            factors      = _mm_blendv_epi8(factors, scaled, laneMask(inside));
+        }
+
+        auto* quad  = reinterpret_cast<__m128i*>(&colors[x]);
+        auto old    = _mm_load_si128(quad);
+        auto scaled = darken(old, factors);
+        _mm_store_si128(quad, _mm_blendv_epi8(old, scaled, laneMask(mask)));
+    }
+}
+
+static lookup_data makeLookup(const shadow_data& shadow, const mat4& screenToWorld) {
+    lookup_data ret;
+    ret.shadow = &shadow;
+    for (size_t c = 0; c < shadow.cascades.size(); c++) {
+        ret.screenToMap[c] = shadow.cascades[c].worldToMap * screenToWorld;
+    }
+    return ret;
+}
+
+void apply(
+        const shadow_data& shadow,
+        const mat4& screenToWorld,
+        texture::texture_data& colorTex,
+        const texture::texture_data& depthTex,
+        const texture::rect& area
+) {
+    assert(colorTex.format != texture::RGB8);
+
+    auto clamped = texture::intersect(area, {0, 0, int(colorTex.width), int(colorTex.height)});
+    if (texture::empty(clamped)) {
+        return;
+    }
+
+    auto lookup  = makeLookup(shadow, screenToWorld);
+    auto* colors = static_cast<u32*>(colorTex.data);
+    auto* depths = static_cast<const float*>(depthTex.data);
+    for (int y = clamped.minY; y < clamped.maxY; y++) {
+        applyRow(
+                lookup,
+                y,
+                clamped.minX,
+                clamped.maxX - 1,
+                &depths[y * depthTex.stride],
+                &colors[y * colorTex.stride],
+                nullptr
+        );
+    }
+}
+
+void apply(
+        const shadow_data& shadow,
+        const mat4& screenToWorld,
+        msaa::msaa_data& msaa,
+        const texture::rect& area
+) {
+    auto clamped = texture::intersect(area, {0, 0, int(msaa.width), int(msaa.height)});
+    if (texture::empty(clamped)) {
+        return;
+    }
+
+    // every sample is looked up at the pixel center, the other planes of uniform pixels are stale
+    auto lookup = makeLookup(shadow, screenToWorld);
+    auto plane  = msaa.stride * msaa.height;
+    for (int s = 0; s < msaa.samples; s++) {
+        for (int y = clamped.minY; y < clamped.maxY; y++) {
+            auto row = s * plane + y * msaa.stride;
+            applyRow(
+                    lookup,
+                    y,
+                    clamped.minX,
+                    clamped.maxX - 1,
+                    &msaa.depths[row],
+                    &msaa.colors[row],
+                    s ? &msaa.uniform[y * msaa.stride] : nullptr
+            );
+        }
+    }
+}
+
+};// namespace sfr::shadow
@@ -0,0 +1,105 @@
+#include "skinning.hpp"
+#include "jobs.hpp"
+#include "math/wide.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace sfr::skinning {
+
+// vertices per job, enough to hide the cost of waking a worker
+static const size_t Grain = 1024;
+
+// one dual quaternion per lane, real and dual parts as x, y, z, w rows
+struct wide_dualquat {
+    vec4x8 real;
+    vec4x8 dual;
+};
+
+static wide_dualquat gather(
+        std::span<const dualquat> palette,
+        const std::array<u16, 4>* joints,
+        size_t influence,
+        size_t count
+) {
+    // straight into component rows, vec4x8::load would go through a second transpose buffer
+    alignas(32) float rows[8][8]{};
+    for (size_t i = 0; i < count; i++) {
+        auto& dq = palette[joints[i][influence]];
+        for (size_t c = 0; c < 4; c++) {
+            rows[c][i]     = dq.real.data[c];
+            rows[c + 4][i] = dq.dual.data[c];
+        }
+    }
+
+    wide_dualquat ret;
+    for (size_t c = 0; c < 4; c++) {
+        ret.real[c] = floatx8::load(rows[c]);
+        ret.dual[c] = floatx8::load(rows[c + 4]);
+    }
+    return ret;
+}
+
+static vec3x8 xyz(const vec4x8& q) {
+    return vec3x8(q.x, q.y, q.z);
+}
+
+// Dual quaternion linear blending, Kavan et al. 2007. Joints whose real part points away from the
+// first one's are flipped before the sum, q and -q are the same transform but cancel out.
+static void skinBatch(
+        const mesh::mesh_data& mesh,
+        std::span<const dualquat> palette,
+        std::span<vec3> out,
+        size_t first,
+        size_t count
+) {
+    auto* joints = &mesh.joints[first];
+    auto weights = vec4x8::load(&mesh.weights[first], count);
+
+    auto pivot = gather(palette, joints, 0, count);
+    auto real  = pivot.real * weights.x;
+    auto dual  = pivot.dual * weights.x;
+    for (size_t k = 1; k < 4; k++) {
+        auto dq     = gather(palette, joints, k, count);
+        auto weight = weights[k];
+        weight      = select(dot(pivot.real, dq.real) < floatx8(0.f), -weight, weight);
+
+        for (size_t c = 0; c < 4; c++) {
+            real[c] = fma(dq.real[c], weight, real[c]);
+            dual[c] = fma(dq.dual[c], weight, dual[c]);
+        }
+    }
+
+    auto scale = rsqrt<precision::fast>(dot(real, real));
+    real       = real * scale;
+    dual       = dual * scale;
+
+    // rotation p + 2 r x (r x p + w p), translation 2 (w_r d - w_d r + r x d)
+    auto p  = vec3x8::load(&mesh.vertices[first], count);
+    auto r  = xyz(real);
+    auto d  = xyz(dual);
+    auto t  = cross(r, fma(p, real.w, cross(r, p)));
+    auto tr = fma(d, real.w, cross(r, d)) - r * dual.w;
+
+    auto two = floatx8(2.f);
+    (p + two * (t + tr)).store(&out[first], count);
+}
+
+void skin(const mesh::mesh_data& mesh, std::span<const dualquat> palette, std::span<vec3> out) {
+    auto count = mesh.vertices.size();
+    assert(out.size() >= count);
+
+    if (mesh.weights.empty()) {
+        std::copy(mesh.vertices.begin(), mesh.vertices.end(), out.begin());
+        return;
+    }
+    assert(mesh.weights.size() == count && mesh.joints.size() == count);
+
+    jobs::parallelFor(count, Grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i += 8) {
+            skinBatch(mesh, palette, out, i, std::min<size_t>(8, end - i));
+        }
+    });
+}
+
+};// namespace sfr::skinning
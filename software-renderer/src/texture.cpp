@@ -1,40 +1,178 @@
 #include "texture.hpp"
+#include "jobs.hpp"
+#include "kernels.hpp"
 
-static int index(int x, int y, size_t width) { return y * width + x; }
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+static int index(int x, int y, size_t stride) { return y * stride + x; }
 
 namespace sfr::texture {
 
-texture_data create(size_t width, size_t height, type textureType) {
+constexpr size_t Alignment = 64;
+// rows per conversion job
+constexpr size_t ConvertGrain = 16;
+
+// byte offsets of r, g and b inside a pixel
+static const int channelOffsets[3][3] = {
+    {0, 1, 2},
+    {0, 1, 2},
+    {2, 1, 0},
+};
+
+static bool packed(pixel_format format) { return format != RGB8; }
+
+static color unpack(const u8* pixel, pixel_format format) {
+    auto* offsets = channelOffsets[format];
+    return color(pixel[offsets[0]], pixel[offsets[1]], pixel[offsets[2]]);
+}
+
+static void store(u8* pixel, pixel_format format, const color& col) {
+    if (packed(format)) {
+        auto value = pack(col, format);
+        std::memcpy(pixel, &value, sizeof(value));
+    } else {
+        std::memcpy(pixel, &col, sizeof(color));
+    }
+}
+
+// depth rows are padded to whole quads like the packed color formats
+static size_t textureStride(type textureType, size_t width, pixel_format format) {
+    return textureType == Color ? rowStride(width, format) : (width + 3) & ~size_t(3);
+}
+
+static __m128i quadMask(int mask) {
+    return _mm_set_epi32(
+            mask & 8 ? -1 : 0,
+            mask & 4 ? -1 : 0,
+            mask & 2 ? -1 : 0,
+            mask & 1 ? -1 : 0
+    );
+}
+
+// pshufb control moving 4 pixels from one layout to another, 0x80 zeroes the byte
+static __m128i shuffleMask(pixel_format src, pixel_format dst) {
+    alignas(16) u8 control[16];
+    std::memset(control, 0x80, sizeof(control));
+
+    auto srcSize = pixelSize(src);
+    auto dstSize = pixelSize(dst);
+    for (int i = 0; i < 4; i++) {
+        for (int c = 0; c < 3; c++) {
+            control[i * dstSize + channelOffsets[dst][c]] = i * srcSize + channelOffsets[src][c];
+        }
+        if (packed(src) && packed(dst)) {
+            control[i * dstSize + 3] = i * srcSize + 3;
+        }
+    }
+    return _mm_load_si128(reinterpret_cast<__m128i*>(control));
+}
+
+// the x range of area in whole quads, clamped to the padded row
+static void quadSpan(const rect& area, size_t stride, size_t& begin, size_t& count) {
+    begin = size_t(std::max(area.minX, 0)) & ~size_t(3);
+    count = std::min((size_t(std::max(area.maxX, 0)) + 3) & ~size_t(3), stride) - begin;
+}
+
+bool empty(const rect& area) { return area.minX >= area.maxX || area.minY >= area.maxY; }
+
+rect merge(const rect& a, const rect& b) {
+    if (empty(a)) {
+        return b;
+    }
+    if (empty(b)) {
+        return a;
+    }
+    return {
+            std::min(a.minX, b.minX),
+            std::min(a.minY, b.minY),
+            std::max(a.maxX, b.maxX),
+            std::max(a.maxY, b.maxY)
+    };
+}
+
+rect intersect(const rect& a, const rect& b) {
+    return {
+            std::max(a.minX, b.minX),
+            std::max(a.minY, b.minY),
+            std::min(a.maxX, b.maxX),
+            std::min(a.maxY, b.maxY)
+    };
+}
+
+size_t pixelSize(pixel_format format) { return packed(format) ? sizeof(u32) : sizeof(color); }
+
+size_t rowStride(size_t width, pixel_format format) {
+    return packed(format) ? (width + 3) & ~size_t(3) : width;
+}
+
+size_t byteSize(size_t width, size_t height, pixel_format format) {
+    return rowStride(width, format) * height * pixelSize(format);
+}
+
+u32 pack(const color& col, pixel_format format) {
+    switch (format) {
+    case RGBA8:
+        return col.r | (col.g << 8) | (col.b << 16) | 0xFF000000u;
+    case BGRA8:
+        return col.b | (col.g << 8) | (col.r << 16) | 0xFF000000u;
+    default:
+        return col.r | (col.g << 8) | (col.b << 16);
+    }
+}
+
+texture_data create(size_t width, size_t height, type textureType, pixel_format format) {
     texture_data ret;
-    ret.type   = textureType;
-    ret.width  = width;
-    ret.height = height;
+    ret.type     = textureType;
+    ret.format   = format;
+    ret.width    = width;
+    ret.height   = height;
+    ret.stride   = textureStride(textureType, width, format);
+    ret.external = false;
 
-    if (textureType == Color) {
+    if (textureType == Color && packed(format)) {
+        auto size = byteSize(width, height, format);
+        ret.data  = ::operator new[](size, std::align_val_t(Alignment));
+        clear(ret, color{});
+    } else if (textureType == Color) {
         auto* data = new color[width * height];
         for (int i = 0; i < width * height; i++) {
             data[i] = color{};
         }
         ret.data = data;
     } else {
-        auto* data = new vec3[width * height];
-        for (int i = 0; i < width * height; i++) {
-            data[i] = vec3{1.f};
-        }
-        ret.data = data;
+        auto size = ret.stride * height * sizeof(float);
+        ret.data  = ::operator new[](size, std::align_val_t(Alignment));
+        clear(ret, vec3{1.f});
     }
     return ret;
 }
 
+texture_data wrap(void* data, size_t width, size_t height, type textureType, pixel_format format) {
+    assert(!packed(format) || reinterpret_cast<uintptr_t>(data) % 16 == 0);
+
+    texture_data ret;
+    ret.type     = textureType;
+    ret.format   = format;
+    ret.width    = width;
+    ret.height   = height;
+    ret.stride   = textureStride(textureType, width, format);
+    ret.data     = data;
+    ret.external = true;
+    return ret;
+}
+
 void destroy(texture_data& tex) {
-    if (tex.type == Color) {
+    if (tex.external) {
+        tex.data = nullptr;
+    } else if (tex.type == Color && !packed(tex.format)) {
         auto* data = static_cast<color*>(tex.data);
         delete[] data;
 
         tex.data = nullptr;
     } else {
-        auto* data = static_cast<vec3*>(tex.data);
-        delete[] data;
+        ::operator delete[](tex.data, std::align_val_t(Alignment));
 
         tex.data = nullptr;
     }
@@ -43,51 +181,182 @@ void destroy(texture_data& tex) {
 void clear(texture_data& tex, const vec3& col) {
     assert(tex.type == Depth);
 
-    auto* data = static_cast<vec3*>(tex.data);
-    for (int i = 0; i < tex.width * tex.height; i++) {
-        data[i] = col;
-    }
+    u32 bits;
+    std::memcpy(&bits, &col.r, sizeof(bits));
+    kernels::get().fill32(tex.data, bits, tex.stride * tex.height);
 }
 
 void clear(texture_data& tex, const color& col) {
     assert(tex.type == Color);
 
+    if (packed(tex.format)) {
+        // rows are padded to whole quads, so the image is one run of aligned stores
+        kernels::get().fill32(tex.data, pack(col, tex.format), tex.stride * tex.height);
+        return;
+    }
+
     auto* data = static_cast<color*>(tex.data);
     for (int i = 0; i < tex.width * tex.height; i++) {
         data[i] = col;
     }
 }
 
-float getDepth(texture_data& tex, int x, int y) {
+void clear(texture_data& tex, const vec3& col, const rect& area) {
     assert(tex.type == Depth);
 
-    auto idx   = index(x, y, tex.width);
-    auto* data = static_cast<vec3*>(tex.data);
-    return data[idx].r;
+    u32 bits;
+    std::memcpy(&bits, &col.r, sizeof(bits));
+    auto clamped = intersect(area, {0, 0, int(tex.width), int(tex.height)});
+    if (empty(clamped)) {
+        return;
+    }
+
+    size_t begin, count;
+    quadSpan(clamped, tex.stride, begin, count);
+    auto* data = static_cast<float*>(tex.data);
+    for (int y = clamped.minY; y < clamped.maxY; y++) {
+        kernels::get().fill32(&data[y * tex.stride + begin], bits, count);
+    }
 }
 
-color* getPixel(texture_data& tex, int x, int y) {
+void clear(texture_data& tex, const color& col, const rect& area) {
     assert(tex.type == Color);
 
-    auto idx   = index(x, y, tex.width);
+    auto clamped = intersect(area, {0, 0, int(tex.width), int(tex.height)});
+    if (empty(clamped)) {
+        return;
+    }
+
+    if (packed(tex.format)) {
+        size_t begin, count;
+        quadSpan(clamped, tex.stride, begin, count);
+        auto value = pack(col, tex.format);
+        auto* data = static_cast<u32*>(tex.data);
+        for (int y = clamped.minY; y < clamped.maxY; y++) {
+            kernels::get().fill32(&data[y * tex.stride + begin], value, count);
+        }
+        return;
+    }
+
     auto* data = static_cast<color*>(tex.data);
-    return &data[idx];
+    for (int y = clamped.minY; y < clamped.maxY; y++) {
+        for (int x = clamped.minX; x < clamped.maxX; x++) {
+            data[index(x, y, tex.stride)] = col;
+        }
+    }
+}
+
+float getDepth(texture_data& tex, int x, int y) {
+    assert(tex.type == Depth);
+
+    auto idx   = index(x, y, tex.stride);
+    auto* data = static_cast<float*>(tex.data);
+    return data[idx];
+}
+
+color getPixel(texture_data& tex, int x, int y) {
+    assert(tex.type == Color);
+
+    auto idx   = index(x, y, tex.stride);
+    auto* data = static_cast<u8*>(tex.data);
+    return unpack(&data[idx * pixelSize(tex.format)], tex.format);
 }
 
 void setPixel(texture_data& tex, int x, int y, const vec3& col) {
     assert(tex.type == Depth);
 
-    auto idx   = index(x, y, tex.width);
-    auto* data = static_cast<vec3*>(tex.data);
-    data[idx]  = col;
+    auto idx   = index(x, y, tex.stride);
+    auto* data = static_cast<float*>(tex.data);
+    data[idx]  = col.r;
 }
 
 void setPixel(texture_data& tex, int x, int y, const color& col) {
     assert(tex.type == Color);
 
-    auto idx   = index(x, y, tex.width);
+    auto idx   = index(x, y, tex.stride);
+    auto* data = static_cast<u8*>(tex.data);
+    store(&data[idx * pixelSize(tex.format)], tex.format, col);
+}
+
+void setPixels(texture_data& tex, int x, int y, int mask, const color& col) {
+    assert(tex.type == Color);
+    assert(x % 4 == 0);
+
+    auto idx = index(x, y, tex.stride);
+    if (packed(tex.format)) {
+        auto* quad = reinterpret_cast<__m128i*>(static_cast<u32*>(tex.data) + idx);
+        auto value = _mm_set1_epi32(pack(col, tex.format));
+        if ((mask & 0xF) != 0xF) {
+            value = _mm_blendv_epi8(_mm_load_si128(quad), value, quadMask(mask));
+        }
+        _mm_store_si128(quad, value);
+        return;
+    }
+
     auto* data = static_cast<color*>(tex.data);
-    data[idx]  = col;
+    for (int i = 0; i < 4 && x + i < tex.width; i++) {
+        if (mask & (1 << i)) {
+            data[idx + i] = col;
+        }
+    }
+}
+
+void convertRow(const texture_data& tex, size_t y, pixel_format format, void* out) {
+    assert(tex.type == Color);
+
+    auto srcSize = pixelSize(tex.format);
+    auto dstSize = pixelSize(format);
+    auto* src    = static_cast<const u8*>(tex.data) + y * tex.stride * srcSize;
+    auto* dst    = static_cast<u8*>(out);
+
+    auto control = shuffleMask(tex.format, format);
+    auto alpha   = !packed(tex.format) && packed(format) ? _mm_set1_epi32(0xFF000000)
+                                                         : _mm_setzero_si128();
+
+    size_t x = 0;
+    if (packed(tex.format) && packed(format)) {
+        alignas(16) u8 bytes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(bytes), control);
+
+        x = tex.width & ~size_t(3);
+        kernels::get().shuffle32(reinterpret_cast<const u32*>(src), static_cast<u32*>(out), x, bytes);
+    }
+    for (; x + 4 <= tex.width; x += 4) {
+        __m128i pixels;
+        if (packed(tex.format)) {
+            pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * srcSize));
+        } else {
+            i32 tail;
+            std::memcpy(&tail, src + x * srcSize + 8, sizeof(tail));
+            pixels = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x * srcSize));
+            pixels = _mm_insert_epi32(pixels, tail, 2);
+        }
+
+        pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, control), alpha);
+
+        if (packed(format)) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * dstSize), pixels);
+        } else {
+            i32 tail = _mm_extract_epi32(pixels, 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * dstSize), pixels);
+            std::memcpy(dst + x * dstSize + 8, &tail, sizeof(tail));
+        }
+    }
+
+    for (; x < tex.width; x++) {
+        store(dst + x * dstSize, format, unpack(src + x * srcSize, tex.format));
+    }
+}
+
+void convert(const texture_data& src, texture_data& dst) {
+    assert(src.width == dst.width && src.height == dst.height);
+
+    auto rowBytes = dst.stride * pixelSize(dst.format);
+    jobs::parallelFor(src.height, ConvertGrain, [&](size_t begin, size_t end) {
+        for (auto y = begin; y < end; y++) {
+            convertRow(src, y, dst.format, static_cast<u8*>(dst.data) + y * rowBytes);
+        }
+    });
 }
 
 };// namespace sfr::texture
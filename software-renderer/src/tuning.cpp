@@ -0,0 +1,191 @@
+#include "tuning.hpp"
+#include "arena.hpp"
+#include "jobs.hpp"
+#include "kernels.hpp"
+#include "raster.hpp"
+#include "texture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace sfr::tuning {
+
+// tile heights tried are the height split into this many bands, none under MinTileRows rows
+static const int BandCounts[] = {2, 4, 8, 16, 32, 64};
+static const int MinTileRows  = 8;
+// timed frames per candidate after a warm up one, the fastest counts
+static const int Runs = 3;
+
+std::string signature(int width, int height) {
+    long l2 = 0;
+#ifdef __linux__
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    return "cores " + std::to_string(jobs::defaultThreads()) + ", l2 " + std::to_string(l2) + ", " +
+           kernels::name(kernels::active()) + ", " + std::to_string(width) + "x" + std::to_string(height);
+}
+
+// A couple of triangles over the whole screen, some large ones and many small ones, at random
+// depths so the depth test goes both ways.
+static void syntheticScene(int width, int height, std::vector<vec3>& vertices, std::vector<u32>& indices) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> x(0.f, float(width)), y(0.f, float(height)), z(0.05f, 0.95f);
+
+    auto add = [&](float size, int count) {
+        std::uniform_real_distribution<float> offset(-size, size);
+        for (int i = 0; i < count; i++) {
+            auto center = vec3(x(rng), y(rng), 0.f);
+            for (int k = 0; k < 3; k++) {
+                indices.push_back(u32(vertices.size()));
+                vertices.push_back(vec3(center.x + offset(rng), center.y + offset(rng), z(rng)));
+            }
+        }
+    };
+
+    auto w = float(width), h = float(height);
+    vertices = {{0.f, 0.f, 0.99f}, {w, 0.f, 0.99f}, {w, h, 0.99f}, {0.f, h, 0.99f}};
+    indices  = {0, 1, 2, 0, 2, 3};
+    add(std::min(w, h) / 3.f, 48);
+    add(24.f, 512);
+}
+
+static double frameTime(
+        const std::vector<vec3>& vertices,
+        const std::vector<u32>& indices,
+        texture::texture_data& colorTex,
+        texture::texture_data& depthTex,
+        int width,
+        int height,
+        int tileRows
+) {
+    static const std::vector<color> colors = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}};
+    using clock = std::chrono::steady_clock;
+
+    raster::triangle_buffer triangles;
+    auto best = 0.0;
+    for (int run = 0; run <= Runs; run++) {
+        auto start = clock::now();
+
+        raster::setupTriangles(triangles, vertices, indices, {0, 0, width, height});
+        raster::binTriangles(triangles, tileRows, height);
+        auto bands = size_t((height + tileRows - 1) / tileRows);
+        jobs::parallelFor(bands, 1, [&](size_t begin, size_t end) {
+            for (auto band = begin; band < end; band++) {
+                texture::rect tile{0, int(band) * tileRows, width, std::min(int(band + 1) * tileRows, height)};
+                texture::clear(colorTex, color{}, tile);
+                texture::clear(depthTex, vec3(1.f), tile);
+                raster::target_data target{&colorTex, &depthTex, nullptr, tile};
+                raster::drawTriangles(target, triangles, colors);
+            }
+        });
+
+        auto time = std::chrono::duration<double>(clock::now() - start).count();
+        arena::nextFrame();
+        // the first run only warms the caches up
+        if (run == 1 || (run > 1 && time < best)) {
+            best = time;
+        }
+    }
+    return best;
+}
+
+settings calibrate(int width, int height) {
+    std::vector<vec3> vertices;
+    std::vector<u32> indices;
+    syntheticScene(width, height, vertices, indices);
+
+    auto colorTex = texture::create(width, height, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(width, height, texture::Depth);
+
+    std::vector<int> tileRows;
+    for (auto bands: BandCounts) {
+        auto rows = std::max((height + bands - 1) / bands, MinTileRows);
+        if (std::find(tileRows.begin(), tileRows.end(), rows) == tileRows.end()) {
+            tileRows.push_back(rows);
+        }
+    }
+    auto current = jobs::workerCount();
+    auto cores   = jobs::defaultThreads();
+    std::vector<size_t> threads;
+    for (size_t count = 1; count < cores; count *= 2) {
+        threads.push_back(count);
+    }
+    threads.push_back(cores);
+
+    settings best{tileRows.front(), cores};
+    auto bestTime = -1.0;
+    for (auto count: threads) {
+        jobs::setThreads(count);
+        for (auto rows: tileRows) {
+            auto time = frameTime(vertices, indices, colorTex, depthTex, width, height, rows);
+            if (bestTime < 0.0 || time < bestTime) {
+                best     = {rows, count};
+                bestTime = time;
+            }
+        }
+    }
+    jobs::setThreads(current);
+
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+    return best;
+}
+
+bool load(const std::string& path, int width, int height, settings& out) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    settings read{0, 0};
+    bool matches = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        auto split = line.find('=');
+        if (line.empty() || line[0] == '#' || split == std::string::npos) {
+            continue;
+        }
+        auto key = line.substr(0, split), value = line.substr(split + 1);
+        if (key == "signature") {
+            matches = value == signature(width, height);
+        } else if (key == "tileRows") {
+            read.tileRows = std::atoi(value.c_str());
+        } else if (key == "threads") {
+            read.threads = size_t(std::atoll(value.c_str()));
+        }
+    }
+
+    if (!matches || read.tileRows <= 0 || read.threads == 0) {
+        return false;
+    }
+    out = read;
+    return true;
+}
+
+void save(const std::string& path, int width, int height, const settings& tuned) {
+    std::ofstream out(path);
+    out << "# calibrated by sfr::tuning, delete to calibrate again\n";
+    out << "signature=" << signature(width, height) << "\n";
+    out << "tileRows=" << tuned.tileRows << "\n";
+    out << "threads=" << tuned.threads << "\n";
+}
+
+settings tune(const std::string& path, int width, int height) {
+    settings tuned;
+    if (!load(path, width, height, tuned)) {
+        tuned = calibrate(width, height);
+        save(path, width, height, tuned);
+    }
+    jobs::setThreads(tuned.threads);
+    return tuned;
+}
+
+};// namespace sfr::tuning
@@ -0,0 +1,39 @@
+#include "vertex.hpp"
+#include "jobs.hpp"
+#include "kernels.hpp"
+
+#include <cassert>
+
+namespace sfr::vertex {
+
+// vertices per job, the input and both outputs of a range stay within L2
+static const size_t Grain = 4096;
+
+void transform(const mat4& m, std::span<const vec3> points, std::span<vec3> out, bool project, precision divide) {
+    assert(out.size() >= points.size());
+
+    auto& kernels = kernels::get();
+    jobs::parallelFor(points.size(), Grain, [&](size_t begin, size_t end) {
+        kernels.transformPoints(&m[0][0], &points[begin].x, &out[begin].x, end - begin, project, divide);
+    });
+}
+
+void project(
+        const mat4& viewProjection,
+        const mat4& viewport,
+        std::span<const vec3> vertices,
+        std::span<vec3> clip,
+        std::span<vec3> screen,
+        precision divide
+) {
+    assert(clip.size() >= vertices.size() && screen.size() >= vertices.size());
+
+    auto& kernels = kernels::get();
+    jobs::parallelFor(vertices.size(), Grain, [&](size_t begin, size_t end) {
+        auto count = end - begin;
+        kernels.transformPoints(&viewProjection[0][0], &vertices[begin].x, &clip[begin].x, count, true, divide);
+        kernels.transformPoints(&viewport[0][0], &clip[begin].x, &screen[begin].x, count, false, precision::exact);
+    });
+}
+
+};// namespace sfr::vertex
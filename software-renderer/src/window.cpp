@@ -76,12 +76,19 @@ static u32 createShaderProgram(const std::string& vertexPath, const std::string&
     return program;
 }
 
+// client layout and type of each color format, the 32-bit ones upload without a swizzle
+static const u32 uploadFormats[][2] = {
+    {GL_RGB, GL_UNSIGNED_BYTE},
+    {GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV},
+    {GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV},
+};
+
 static u32 createTexture(const void* data, int width, int height) {
     u32 texture;
     glGenTextures(1, &texture);
     glBindTexture(GL_TEXTURE_2D, texture);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -90,38 +97,134 @@ static u32 createTexture(const void* data, int width, int height) {
     return texture;
 }
 
-static u32 createPBO(int width, int height) {
+static u32 createPBO(size_t size) {
     u32 pbo;
     glGenBuffers(1, &pbo);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, width * height * 3, nullptr, GL_STREAM_DRAW);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     return pbo;
 }
 
-static void updateTexture(
-        unsigned int texture,
-        unsigned int pbo,
-        int width,
-        int height,
-        const void* data
-) {
+static bool persistentMappingSupported() {
+    return gl3wIsSupported(4, 4) || glfwExtensionSupported("GL_ARB_buffer_storage");
+}
+
+// Upload buffer that stays mapped for its whole lifetime, the renderer writes frames into it.
+static void* createPersistentPBO(u32& pbo, size_t size) {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &pbo);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
-    void* buffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
-    if (buffer) {
-        std::memcpy(buffer, data, width * height * 3);
-        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!mapped) {
+        glDeleteBuffers(1, &pbo);
+        pbo = 0;
     }
+    return mapped;
+}
+
+static void waitFence(void*& fence) {
+    if (!fence) {
+        return;
+    }
+
+    auto sync = static_cast<GLsync>(fence);
+    while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+    glDeleteSync(sync);
+    fence = nullptr;
+}
+
+// Uploads frame from the currently bound unpack buffer, pixels being an offset into it.
+static void uploadTexture(u32 texture, const sfr::texture::texture_data& frame, size_t pixels) {
+    auto* format = uploadFormats[frame.format];
 
     glBindTexture(GL_TEXTURE_2D, texture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, frame.stride);
+    glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            frame.width,
+            frame.height,
+            format[0],
+            format[1],
+            (void*) pixels
+    );
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+static void updateTexture(u32 texture, u32 pbo, const sfr::texture::texture_data& frame) {
+    auto size = sfr::texture::byteSize(frame.width, frame.height, frame.format);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    void* buffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (buffer) {
+        std::memcpy(buffer, frame.data, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    uploadTexture(texture, frame, 0);
+}
+
 namespace sfr::window {
 
-window_data init(int width, int height) {
+static void attachSurface(void* user) {
+    auto* surface = static_cast<window_surface*>(user);
+    glfwMakeContextCurrent(surface->glfwWindow);
+}
+
+static void detachSurface(void* user) { glfwMakeContextCurrent(nullptr); }
+
+static void presentSurface(void* user, const texture::texture_data& frame) {
+    auto* surface = static_cast<window_surface*>(user);
+
+    // zero-copy path: the frame already lives in the mapped ring, only its offset is uploaded
+    if (surface->mapped) {
+        auto offset = static_cast<const u8*>(frame.data) - static_cast<const u8*>(surface->mapped);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, surface->pbo);
+        uploadTexture(surface->texture, frame, offset);
+
+        // waited on by reclaimSurface, before the renderer writes the slot again
+        surface->fences[offset / surface->frameBytes] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    } else {
+        updateTexture(surface->texture, surface->pbo, frame);
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUseProgram(surface->program);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, surface->texture);
+
+    glBindVertexArray(surface->VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    glfwSwapBuffers(surface->glfwWindow);
+}
+
+// only when the renderer asks for the slot again, by then its upload is long done in most frames
+static void reclaimSurface(void* user, const texture::texture_data& frame) {
+    auto* surface = static_cast<window_surface*>(user);
+    if (surface->mapped) {
+        auto offset = static_cast<const u8*>(frame.data) - static_cast<const u8*>(surface->mapped);
+        waitFence(surface->fences[offset / surface->frameBytes]);
+    }
+}
+
+window_data init(
+        int width,
+        int height,
+        int bufferCount,
+        bool persistentMapping,
+        texture::pixel_format format
+) {
     window_data window;
     window.width  = width;
     window.height = height;
@@ -138,7 +241,10 @@ window_data init(int width, int height) {
         exit(-1);
     }
 
-    window.glfwWindow = glfwWindow;
+    auto* surface       = new window_surface;
+    surface->glfwWindow = glfwWindow;
+    surface->width      = width;
+    surface->height     = height;
     glfwMakeContextCurrent(glfwWindow);
 
     if (gl3wInit()) {
@@ -146,36 +252,78 @@ window_data init(int width, int height) {
         exit(-1);
     }
 
-    window.program = createShaderProgram("screen.vert", "screen.frag");
+    surface->program = createShaderProgram("screen.vert", "screen.frag");
 
-    glGenBuffers(1, &window.VBO);
-    glGenVertexArrays(1, &window.VAO);
+    glGenBuffers(1, &surface->VBO);
+    glGenVertexArrays(1, &surface->VAO);
 
-    glBindVertexArray(window.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, window.VBO);
+    glBindVertexArray(surface->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, surface->VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*) 0);
     glEnableVertexAttribArray(0);
 
-    window.colorBuf = texture::create(width, height);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    surface->frameBytes = texture::byteSize(width, height, format);
+    surface->mapped     = nullptr;
+    for (auto& fence: surface->fences) {
+        fence = nullptr;
+    }
+    if (persistentMapping && persistentMappingSupported()) {
+        surface->mapped = createPersistentPBO(surface->pbo, surface->frameBytes * bufferCount);
+    }
+    if (!surface->mapped) {
+        surface->pbo = createPBO(surface->frameBytes);
+    }
+    surface->texture = createTexture(nullptr, width, height);
+
+    // the present thread owns the context from here on
+    glfwMakeContextCurrent(nullptr);
+
+    window.surface  = surface;
+    window.present  = present::create(
+            {surface, surface->mapped, attachSurface, detachSurface, presentSurface, reclaimSurface},
+            width,
+            height,
+            bufferCount,
+            format
+    );
+    window.colorBuf = &present::acquire(window.present);
     window.depthBuf = texture::create(width, height, sfr::texture::Depth);
-    window.pbo      = createPBO(width, height);
-    window.texture  = createTexture(window.colorBuf.data, width, height);
 
     return window;
 }
 
 void destroy(window_data& window) {
-    glDeleteVertexArrays(1, &window.VAO);
-    glDeleteBuffers(1, &window.VBO);
-    glDeleteProgram(window.program);
-    glDeleteTextures(1, &window.texture);
+    present::flush(window.present);
+    present::destroy(window.present);
+    texture::destroy(window.depthBuf);
+
+    auto* surface = window.surface;
+    glfwMakeContextCurrent(surface->glfwWindow);
+    if (surface->mapped) {
+        for (auto& fence: surface->fences) {
+            waitFence(fence);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, surface->pbo);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    glDeleteVertexArrays(1, &surface->VAO);
+    glDeleteBuffers(1, &surface->VBO);
+    glDeleteBuffers(1, &surface->pbo);
+    glDeleteProgram(surface->program);
+    glDeleteTextures(1, &surface->texture);
+    delete surface;
+
+    window.surface = nullptr;
     glfwTerminate();
 }
 
 void clear(window_data& window, const color& col) {
-    texture::clear(window.colorBuf, col);
+    texture::clear(*window.colorBuf, col);
     texture::clear(window.depthBuf, vec3(1.f));
 }
 
@@ -183,7 +331,14 @@ void setPixel(window_data& window, int x, int y, const color& col) {
     assert(x >= 0 && x < window.width);
     assert(y >= 0 && y < window.height);
 
-    texture::setPixel(window.colorBuf, x, y, col);
+    texture::setPixel(*window.colorBuf, x, y, col);
+}
+
+void setPixels(window_data& window, int x, int y, int mask, const color& col) {
+    assert(x >= 0 && x < window.width);
+    assert(y >= 0 && y < window.height);
+
+    texture::setPixels(*window.colorBuf, x, y, mask, col);
 }
 
 void setDepth(window_data& window, int x, int y, const float& depth) {
@@ -201,23 +356,16 @@ float getDepth(window_data& window, int x, int y) {
 }
 
 void blitPixels(window_data& window) {
-    updateTexture(window.texture, window.pbo, window.width, window.height, window.colorBuf.data);
+    present::submit(window.present);
+    window.colorBuf = &present::acquire(window.present);
 }
 
 void display(window_data& window) {
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    glUseProgram(window.program);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, window.texture);
-
-    glBindVertexArray(window.VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-
-    glfwSwapBuffers(window.glfwWindow);
+    // upload and swap happen on the present thread, only events are pumped here
     glfwPollEvents();
 }
 
-bool shouldClose(window_data& window) { return glfwWindowShouldClose(window.glfwWindow); }
+void waitEvents(window_data& window) { glfwWaitEvents(); }
+
+bool shouldClose(window_data& window) { return glfwWindowShouldClose(window.surface->glfwWindow); }
 };// namespace sfr::window
\ No newline at end of file
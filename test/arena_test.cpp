@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "arena.hpp"
+#include "graph.hpp"
+#include "jobs.hpp"
+#include "raster.hpp"
+#include "shadow.hpp"
+#include "vertex.hpp"
+#include "math/transform.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace sfr;
+
+// every heap allocation of the process goes through these, counted
+static std::atomic<size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* ret = std::malloc(size ? size : 1)) {
+        return ret;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = size_t(alignment);
+    if (auto* ret = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align)) {
+        return ret;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+TEST_CASE("allocations are aligned, zeroed and dropped at once", "[arena]") {
+    arena::arena_data frame;
+
+    auto a = arena::allocate<u32>(frame, 3);
+    auto b = arena::allocate<float>(frame, 100);
+    REQUIRE(reinterpret_cast<uintptr_t>(a.data()) % arena::Alignment == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(b.data()) % arena::Alignment == 0);
+    REQUIRE(a[0] == 0);
+    REQUIRE(b[99] == 0.f);
+    REQUIRE(frame.used == 64 + 448);
+
+    // the first frame spills, the next one gets a block that holds all of it
+    arena::reset(frame);
+    REQUIRE(frame.capacity == 64 + 448);
+    auto again = arena::allocate<u32>(frame, 3);
+
+    // rewinding gives back the space, the next allocation lands at the same place
+    auto start = arena::mark(frame);
+    auto first = arena::allocate<float>(frame, 100);
+    arena::rewind(frame, start);
+    REQUIRE(arena::allocate<u8>(frame, 10).data() == reinterpret_cast<u8*>(first.data()));
+    REQUIRE(frame.spills.empty());
+    REQUIRE(frame.highWater == 64 + 448);
+
+    arena::reset(frame);
+    REQUIRE(arena::allocate<u32>(frame, 3).data() == again.data());
+    arena::destroy(frame);
+    REQUIRE(frame.block == nullptr);
+}
+
+TEST_CASE("local arenas belong to their thread and start over every frame", "[arena]") {
+    auto* mine  = &arena::local();
+    auto caller = std::this_thread::get_id();
+    std::atomic<int> wrong = 0;
+    jobs::parallelFor(64, 1, [&](size_t, size_t) {
+        auto& own = arena::local();
+        wrong += (std::this_thread::get_id() == caller) != (&own == mine);
+        arena::allocate<u8>(own, 100);
+    });
+    REQUIRE(wrong == 0);
+
+    arena::allocate<u8>(arena::local(), 100);
+    REQUIRE(arena::local().used > 0);
+    arena::nextFrame();
+    REQUIRE(arena::local().used == 0);
+}
+
+TEST_CASE("stages give back the scratch they only need during the call", "[arena]") {
+    const int width = 64, height = 48;
+    std::vector<vec3> vertices;
+    std::vector<u32> indices;
+    for (u32 i = 0; i < 3000; i++) {
+        vertices.push_back(vec3(float(i * 7 % width), float(i * 13 % height), 0.5f));
+        indices.push_back(i);
+    }
+    auto colorTex = texture::create(width, height, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(width, height, texture::Depth);
+    raster::target_data target{&colorTex, &depthTex, nullptr};
+    raster::triangle_buffer triangles;
+
+    // without nextFrame in between, as tools and tests call them
+    auto& local = arena::local();
+    auto used   = local.used;
+    for (int i = 0; i < 10; i++) {
+        raster::setupTriangles(triangles, vertices, indices, {0, 0, width, height});
+        raster::binTriangles(triangles, 8, height);
+        raster::drawTriangles(target, vertices, indices, {color(255, 0, 0)});
+        raster::drawLines(target, vertices, indices, {color(0, 255, 0)});
+        raster::drawPoints(target, vertices, {color(0, 0, 255)}, 3);
+    }
+    REQUIRE(local.used == used);
+    REQUIRE(local.spills.empty());
+
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+}
+
+TEST_CASE("steady frames allocate nothing", "[arena]") {
+    const int width = 320, height = 180, rows = 16;
+    const int grid  = 24;
+
+    // a bumpy floor of quads below a camera drifting a little frame by frame, drawn the way the
+    // renderer draws a frame: shadow maps, then a graph of tiled passes
+    std::vector<vec3> mesh;
+    std::vector<u32> indices, edges;
+    for (int y = 0; y <= grid; y++) {
+        for (int x = 0; x <= grid; x++) {
+            mesh.push_back(vec3(8.f * x / grid - 4.f, 0.3f * float((x ^ y) & 1), 8.f * y / grid - 4.f));
+        }
+    }
+    for (u32 y = 0; y < grid; y++) {
+        for (u32 x = 0; x < grid; x++) {
+            auto corner = y * (grid + 1) + x;
+            for (auto i: {corner, corner + 1, corner + grid + 2, corner, corner + grid + 2, corner + grid + 1}) {
+                indices.push_back(i);
+            }
+        }
+    }
+    edges = raster::wireframeEdges(indices);
+
+    auto colorTex = texture::create(width, height, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(width, height, texture::Depth);
+    auto shadow   = shadow::create(128, 3, vec3(-0.4f, -1.f, -0.6f));
+    auto frames   = graph::create();
+    std::vector<vec3> clip(mesh.size()), screen(mesh.size());
+    raster::triangle_buffer triangles;
+    std::vector<raster::line_setup> lines;
+    const std::vector<color> colors = {{255, 0, 0}, {0, 255, 0}};
+    const auto toScreen = viewport({-1, -1, 2, 2}, {0, 0, float(width), float(height)});
+    const auto projection = perspective(60.f * float(M_PI / 180.f), float(width) / height, 0.1f, 20.f);
+
+    auto frame = [&](int index) {
+        auto angle          = float(index % 9) * 0.7f;
+        auto eye            = vec3(std::sin(angle) * 0.5f, 6.f, std::cos(angle) * 0.5f);
+        auto viewProjection = projection * view(eye, vec3(0.f, 1.f, 0.f), vec3(1.f, 0.f, 0.f), vec3(0.f, 0.f, -1.f));
+        auto screenToWorld  = inverse(toScreen * viewProjection);
+        vertex::project(viewProjection, toScreen, mesh, clip, screen, precision::fast);
+
+        raster::setupTriangles(triangles, screen, indices, {0, 0, width, height});
+        raster::setupLines(lines, screen, edges, {0, 0, width, height});
+        raster::binTriangles(triangles, rows, height);
+        shadow::render(shadow, viewProjection, 0.1f, 20.f, mesh, indices);
+
+        graph::reset(frames);
+        auto colorRes = graph::importTexture(frames, colorTex);
+        auto depthRes = graph::importTexture(frames, depthTex);
+        graph::addPass(frames, "clear", {}, {colorRes, depthRes}, [&](const texture::rect& tile) {
+            texture::clear(colorTex, color{}, tile);
+            texture::clear(depthTex, vec3(1.f), tile);
+        }, rows);
+        graph::addPass(frames, "depth", {}, {depthRes}, [&](const texture::rect& tile) {
+            raster::target_data target{&colorTex, &depthTex, nullptr, tile};
+            raster::drawDepth(target, triangles);
+        }, rows);
+        graph::addPass(frames, "raster", {depthRes}, {colorRes}, [&](const texture::rect& tile) {
+            raster::target_data target{&colorTex, &depthTex, nullptr, tile};
+            raster::drawTriangles(target, triangles, colors, true);
+        }, rows);
+        graph::addPass(frames, "shadow", {depthRes, colorRes}, {colorRes}, [&](const texture::rect& tile) {
+            shadow::apply(shadow, screenToWorld, colorTex, depthTex, tile);
+        }, rows);
+        graph::addPass(frames, "wireframe", {depthRes, colorRes}, {colorRes}, [&](const texture::rect& tile) {
+            raster::target_data target{&colorTex, &depthTex, nullptr, tile};
+            raster::drawLines(target, lines, colors);
+        }, rows);
+        graph::compile(frames);
+        graph::execute(frames);
+        arena::nextFrame();
+    };
+
+    // the drift repeats every nine frames, the first rounds grow everything to its largest
+    for (int i = 0; i < 27; i++) {
+        frame(i);
+    }
+    auto before = allocations.load();
+    for (int i = 27; i < 54; i++) {
+        frame(i);
+    }
+    auto steady = allocations.load() - before;
+
+    REQUIRE(steady == 0);
+    REQUIRE(frames.levels.size() == 5);
+    REQUIRE(!triangles.index.empty());
+    REQUIRE(texture::getDepth(depthTex, width / 2, height / 2) < 1.f);
+
+    graph::destroy(frames);
+    shadow::destroy(shadow);
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Timings of the math benchmarks checked against stored baselines.
+//
+// Every row times Repeats loops over Count operations Runs times and keeps the fastest run, the one
+// least disturbed by the rest of the machine, then the best of Attempts such timings. Rows are
+// stored relative to a calibration loop timed the same way right before them, so a baseline
+// recorded on one machine holds on another of the same class and a clock change mid run cancels
+// out. A row slower than its baseline by more than the tolerance fails the test.
+// SFR_BENCH_TOLERANCE overrides the tolerance, SFR_BENCH_UPDATE=1 rewrites the baseline file from
+// the current timings instead. Rows as large as a whole frame pass their own repeats, their time is
+// scaled to Repeats loops so the ratio means the same.
+namespace bench {
+
+// small enough for every array of a row to stay in L1
+const size_t Count = 256;
+const int Runs     = 31;
+const int Repeats  = 64;
+const int Attempts = 3;
+const int Retries  = 8;
+
+const double DefaultTolerance = 1.75;
+
+// keeps the compiler from dropping work whose result is never read
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// only the elements escape, the span itself stays in registers and is not reloaded after every
+// store through __m128, which may alias anything
+template <typename T>
+inline void keep(std::span<T> values) {
+    asm volatile("" : : "r"(values.data()) : "memory");
+}
+
+// The arrays a row works on. Each one starts a different number of cache lines past a page
+// boundary, so loads from one never alias stores to another 4 KiB away and timings do not depend on
+// where the heap happened to put them.
+class arrays {
+public:
+    arrays() = default;
+    arrays(const arrays&) = delete;
+    ~arrays() {
+        for (auto* block: blocks) {
+            std::free(block);
+        }
+    }
+
+    template <typename T>
+    std::span<T> make(size_t count, const T& fill = T()) {
+        auto offset = 192 * (blocks.size() % 20 + 1);
+        auto bytes  = (offset + count * sizeof(T) + 4095) & ~size_t(4095);
+        auto* block = static_cast<std::byte*>(std::aligned_alloc(4096, bytes));
+        blocks.push_back(block);
+
+        auto* data = reinterpret_cast<T*>(block + offset);
+        std::uninitialized_fill_n(data, count, fill);
+        return {data, count};
+    }
+
+private:
+    std::vector<std::byte*> blocks;
+};
+
+template <typename F>
+double measure(F&& body, int repeats = Repeats) {
+    using clock = std::chrono::steady_clock;
+
+    body();
+    std::vector<double> times;
+    for (int i = 0; i < Runs; i++) {
+        auto start = clock::now();
+        for (int r = 0; r < repeats; r++) {
+            body();
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+    }
+    return *std::min_element(times.begin(), times.end()) * Repeats / repeats;
+}
+
+class suite {
+public:
+    explicit suite(std::string path) : path(std::move(path)) {
+        auto* tolerance = std::getenv("SFR_BENCH_TOLERANCE");
+        auto* update    = std::getenv("SFR_BENCH_UPDATE");
+        this->tolerance = tolerance ? std::atof(tolerance) : DefaultTolerance;
+        this->update    = update && std::string(update) == "1";
+
+        std::ifstream in(this->path);
+        std::string line;
+        while (std::getline(in, line)) {
+            auto tab = line.rfind('\t');
+            if (line.empty() || line[0] == '#' || tab == std::string::npos) {
+                continue;
+            }
+            baselines[line.substr(0, tab)] = std::atof(line.c_str() + tab + 1);
+        }
+    }
+
+    ~suite() {
+        if (!update) {
+            return;
+        }
+
+        for (auto& [name, ratio]: measured) {
+            baselines[name] = ratio;
+        }
+        std::ofstream out(path);
+        out << "# time per row over the calibration loop, see test/bench.hpp\n";
+        for (auto& [name, ratio]: baselines) {
+            out << name << '\t' << ratio << '\n';
+        }
+    }
+
+    template <typename F>
+    void run(const std::string& name, F&& body, int repeats = Repeats) {
+        auto ratio = calibrated(body, repeats);
+        for (int attempt = 1; attempt < Attempts; attempt++) {
+            ratio = std::min(ratio, calibrated(body, repeats));
+        }
+
+        auto baseline = baselines.find(name);
+        if (update || baseline == baselines.end()) {
+            std::printf("%-40s %8.3f\n", name.c_str(), ratio);
+            measured[name] = ratio;
+            return;
+        }
+
+        // a slow row is usually something else busy on the machine, give it time to pass and
+        // only fail one that stays slow
+        auto limit = baseline->second * tolerance;
+        for (int retry = 0; retry < Retries && ratio > limit; retry++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50 * (retry + 1)));
+            ratio = std::min(ratio, calibrated(body, repeats));
+        }
+        std::printf("%-40s %8.3f  baseline %8.3f\n", name.c_str(), ratio, baseline->second);
+
+        INFO(name << " took " << ratio << " against a baseline of " << baseline->second);
+        CHECK(ratio <= limit);
+    }
+
+private:
+    template <typename F>
+    static double calibrated(F&& body, int repeats) {
+        std::uint32_t x = 1;
+        auto unit       = measure([&] {
+            for (size_t i = 0; i < Count; i++) {
+                x = x * 1664525u + 1013904223u;
+                keep(x);
+            }
+        });
+        return measure(body, repeats) / unit;
+    }
+
+    std::string path;
+    std::map<std::string, double> baselines, measured;
+    double tolerance;
+    bool update;
+};
+
+// One suite per benchmark executable, BENCH_BASELINE names its file.
+inline suite& baselines() {
+    static suite instance(BENCH_BASELINE);
+    return instance;
+}
+
+};// namespace bench
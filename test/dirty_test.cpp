@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "dirty.hpp"
+#include "raster.hpp"
+#include "math/transform.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace sfr;
+
+static const int Width = 61, Height = 37;
+
+static const std::vector<vec3> shape = {
+        {2.f, 3.f, 0.5f}, {20.5f, 4.f, 0.5f}, {9.f, 18.7f, 0.2f},
+        {5.f, 5.f, 0.1f}, {12.f, 6.f, 0.9f}, {7.f, 15.f, 0.9f},
+};
+static const std::vector<u32> indices  = {0, 1, 2, 3, 4, 5};
+static const std::vector<color> colors = {color(255, 0, 0), color(0, 0, 255)};
+// covers the whole screen behind the shape, every pixel is drawn every frame
+static const std::vector<vec3> backdrop = {
+        {0.f, 0.f, 0.8f}, {61.f, 0.f, 0.8f}, {0.f, 37.f, 0.8f},
+        {61.f, 0.f, 0.8f}, {61.f, 37.f, 0.8f}, {0.f, 37.f, 0.8f},
+};
+static const std::vector<color> backColors = {color(10, 200, 10)};
+
+static void place(const mat4& m, std::vector<vec3>& out) {
+    out.resize(shape.size());
+    for (size_t i = 0; i < shape.size(); i++) {
+        out[i] = vec3(m * vec4(shape[i], 1.f));
+    }
+}
+
+static std::vector<u32> pixels(const texture::texture_data& tex) {
+    auto* data = static_cast<u32*>(tex.data);
+    std::vector<u32> ret;
+    for (size_t y = 0; y < tex.height; y++) {
+        ret.insert(ret.end(), data + y * tex.stride, data + y * tex.stride + tex.width);
+    }
+    return ret;
+}
+
+// the whole frame from scratch
+static std::vector<u32> reference(const std::vector<vec3>& screen, int samples) {
+    auto colorTex = texture::create(Width, Height, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(Width, Height, texture::Depth);
+    msaa::msaa_data msaa{};
+    raster::target_data target{&colorTex, &depthTex, nullptr};
+    if (samples > 1) {
+        msaa        = msaa::create(Width, Height, samples, texture::BGRA8);
+        target.msaa = &msaa;
+    }
+
+    raster::drawTriangles(target, backdrop, indices, backColors);
+    raster::drawTriangles(target, screen, indices, colors);
+    if (samples > 1) {
+        msaa::resolve(msaa, colorTex);
+        msaa::destroy(msaa);
+    }
+
+    auto ret = pixels(colorTex);
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+    return ret;
+}
+
+TEST_CASE("tracker collects damage per back buffer", "[dirty]") {
+    auto tracker = dirty::create(Width, Height, 3);
+    REQUIRE(dirty::pending(tracker));
+    REQUIRE(dirty::bufferArea(tracker).maxX == Width);
+
+    // three frames until every buffer was drawn once
+    for (int i = 0; i < 3; i++) {
+        dirty::advance(tracker);
+    }
+    REQUIRE_FALSE(dirty::pending(tracker));
+    REQUIRE(texture::empty(dirty::bufferArea(tracker)));
+
+    dirty::object_data object{};
+    auto m = translate({1.5f, 0.f, 0.f});
+    REQUIRE(dirty::stale(object, m, 0));
+    place(m, object.screen);
+    dirty::update(tracker, object, m, 0);
+    REQUIRE_FALSE(dirty::stale(object, m, 0));
+    REQUIRE(dirty::stale(object, m, 1));
+
+    // floor(3.5) & ~3 to (ceil(22) + 4) & ~3, rows floor(3) to ceil(18.7) + 1
+    auto area = dirty::frameArea(tracker);
+    REQUIRE((area.minX == 0 && area.maxX == 24 && area.minY == 3 && area.maxY == 20));
+    dirty::advance(tracker);
+
+    // the next buffer misses the previous frame too, the one after that both
+    dirty::damage(tracker, {40, 30, 44, 31});
+    REQUIRE(dirty::bufferArea(tracker).maxX == 44);
+    REQUIRE(dirty::bufferArea(tracker).minY == 3);
+    REQUIRE(dirty::frameArea(tracker).minY == 30);
+    dirty::advance(tracker);
+    dirty::advance(tracker);
+    dirty::advance(tracker);
+    REQUIRE(texture::empty(dirty::bufferArea(tracker)));
+}
+
+TEST_CASE("partial redraws match full ones", "[dirty]") {
+    // offsets through the frames, repeated ones leave nothing to draw
+    const float offsets[] = {0.f, 0.f, 3.25f, 3.25f, 3.25f, 7.f, -4.5f, 30.f, 30.f, 52.f};
+
+    for (int samples: {1, 4}) {
+        texture::texture_data buffers[2] = {
+                texture::create(Width, Height, texture::Color, texture::BGRA8),
+                texture::create(Width, Height, texture::Color, texture::BGRA8),
+        };
+        auto depth = texture::create(Width, Height, texture::Depth);
+        msaa::msaa_data msaa{};
+        if (samples > 1) {
+            msaa = msaa::create(Width, Height, samples, texture::BGRA8);
+        }
+
+        auto tracker = dirty::create(Width, Height, 2);
+        dirty::object_data object{};
+        int current = 0, drawn = 0;
+        for (auto offset: offsets) {
+            auto m = translate({offset, 0.5f * offset, 0.f});
+            if (dirty::stale(object, m, 0)) {
+                place(m, object.screen);
+                dirty::update(tracker, object, m, 0);
+            }
+            if (!dirty::pending(tracker)) {
+                continue;
+            }
+
+            auto& colorTex  = buffers[current];
+            auto bufferArea = dirty::bufferArea(tracker);
+            auto drawArea   = samples > 1 ? dirty::frameArea(tracker) : bufferArea;
+            raster::target_data target{&colorTex, &depth, nullptr, drawArea};
+            if (samples > 1) {
+                msaa::clear(msaa, color{}, drawArea);
+                target.msaa = &msaa;
+            } else {
+                texture::clear(colorTex, color{}, drawArea);
+                texture::clear(depth, vec3(1.f), drawArea);
+            }
+
+            raster::drawTriangles(target, backdrop, indices, backColors);
+            raster::drawTriangles(target, object.screen, indices, colors);
+            if (samples > 1) {
+                msaa::resolve(msaa, colorTex, bufferArea);
+            }
+            REQUIRE(pixels(colorTex) == reference(object.screen, samples));
+
+            dirty::advance(tracker);
+            current = 1 - current;
+            drawn++;
+        }
+        // the first frame, and one per move
+        REQUIRE(drawn == 6);
+
+        texture::destroy(buffers[0]);
+        texture::destroy(buffers[1]);
+        texture::destroy(depth);
+        if (samples > 1) {
+            msaa::destroy(msaa);
+        }
+    }
+}
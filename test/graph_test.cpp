@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace sfr;
+
+static const graph::texture_desc depthDesc = {37, 21, texture::Depth, texture::RGB8};
+
+static float& at(texture::texture_data& tex, int x, int y) {
+    return static_cast<float*>(tex.data)[y * tex.stride + x];
+}
+
+// every pixel of tile in tex set to value
+static void fill(texture::texture_data& tex, const texture::rect& tile, float value) {
+    for (int y = tile.minY; y < tile.maxY; y++) {
+        for (int x = tile.minX; x < tile.maxX; x++) {
+            at(tex, x, y) = value;
+        }
+    }
+}
+
+TEST_CASE("graph orders, culls and aliases passes", "[graph]") {
+    auto out   = texture::create(37, 21, texture::Depth);
+    auto graph = graph::create();
+
+    for (int frame = 0; frame < 2; frame++) {
+        graph::reset(graph);
+        auto target = graph::importTexture(graph, out);
+        auto a      = graph::createTexture(graph, depthDesc);
+        auto b      = graph::createTexture(graph, depthDesc);
+        auto c      = graph::createTexture(graph, depthDesc);
+        auto d      = graph::createTexture(graph, depthDesc);
+        auto unused = graph::createTexture(graph, depthDesc);
+
+        std::atomic<int> tiles = 0;
+        graph::addPass(graph, "a", {}, {a}, [&](const texture::rect& tile) {
+            fill(graph::get(graph, a), tile, 1.f);
+            tiles++;
+        }, 4);
+        graph::addPass(graph, "b", {}, {b}, [&](const texture::rect& tile) {
+            fill(graph::get(graph, b), tile, 2.f);
+        });
+        graph::addPass(graph, "unused", {a}, {unused}, [&](const texture::rect& tile) {
+            FAIL("culled passes never run");
+        });
+        graph::addPass(graph, "sum", {a, b}, {c}, [&](const texture::rect& tile) {
+            auto& lhs = graph::get(graph, a);
+            auto& rhs = graph::get(graph, b);
+            for (int y = tile.minY; y < tile.maxY; y++) {
+                for (int x = tile.minX; x < tile.maxX; x++) {
+                    at(graph::get(graph, c), x, y) = at(lhs, x, y) + at(rhs, x, y);
+                }
+            }
+        }, 8);
+        graph::addPass(graph, "offset", {c}, {d}, [&](const texture::rect& tile) {
+            for (int y = tile.minY; y < tile.maxY; y++) {
+                for (int x = tile.minX; x < tile.maxX; x++) {
+                    at(graph::get(graph, d), x, y) = at(graph::get(graph, c), x, y) + float(frame);
+                }
+            }
+        });
+        graph::addPass(graph, "copy", {d}, {target}, [&](const texture::rect& tile) {
+            for (int y = tile.minY; y < tile.maxY; y++) {
+                for (int x = tile.minX; x < tile.maxX; x++) {
+                    at(out, x, y) = at(graph::get(graph, d), x, y);
+                }
+            }
+        });
+        graph::compile(graph);
+
+        // a and b are independent, every other pass waits for the one before
+        REQUIRE(graph.levels.size() == 4);
+        REQUIRE(std::ranges::equal(graph.levels[0], std::vector<u32>{0, 1}));
+        REQUIRE(graph.passes[2].culled);
+        REQUIRE(graph.passes[5].level == 3);
+
+        // d is first written after a and b were read for the last time and takes a's memory,
+        // c is written by the pass reading them and cannot
+        REQUIRE(graph.used == 3 * graph.unaliased / 4);
+        REQUIRE(graph::get(graph, d).data == graph::get(graph, a).data);
+        REQUIRE(graph::get(graph, c).data != graph::get(graph, a).data);
+        REQUIRE(graph::get(graph, c).data != graph::get(graph, b).data);
+
+        graph::execute(graph);
+        REQUIRE(tiles == 6);
+        for (int y = 0; y < 21; y++) {
+            for (int x = 0; x < 37; x++) {
+                REQUIRE(at(out, x, y) == 3.f + float(frame));
+            }
+        }
+    }
+
+    graph::destroy(graph);
+    texture::destroy(out);
+}
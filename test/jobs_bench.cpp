@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench.hpp"
+#include "jobs.hpp"
+
+#include <atomic>
+
+using namespace sfr;
+using bench::Count;
+
+// the pool the baseline was recorded with, whatever the machine's core count
+static const size_t Threads = 4;
+
+// What handing work to the pool costs, with jobs too small to hide any of it: spawning and
+// waiting, ranges split as far as idle workers steal them, and ranges nested in ranges.
+TEST_CASE("job system overhead", "[jobs][bench]") {
+    auto& suite = bench::baselines();
+    jobs::setThreads(Threads);
+    std::atomic<size_t> sum = 0;
+
+    suite.run("spawn and wait", [&] {
+        jobs::counter done;
+        for (size_t i = 0; i < Count; i++) {
+            jobs::spawn(done, [&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+        }
+        jobs::wait(done);
+    });
+
+    suite.run("parallelFor grain 1", [&] {
+        jobs::parallelFor(Count, 1, [&](size_t begin, size_t end) {
+            sum.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+    });
+
+    suite.run("parallelFor nested 16x16", [&] {
+        jobs::parallelFor(16, 1, [&](size_t, size_t) {
+            jobs::parallelFor(16, 1, [&](size_t begin, size_t end) {
+                sum.fetch_add(end - begin, std::memory_order_relaxed);
+            });
+        });
+    });
+
+    bench::keep(sum);
+}
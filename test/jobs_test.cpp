@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "jobs.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace sfr;
+
+TEST_CASE("parallelFor runs every item once", "[jobs]") {
+    REQUIRE(jobs::workerCount() >= 1);
+
+    for (size_t count: {0, 1, 7, 1000, 4097}) {
+        std::vector<std::atomic<int>> hits(count);
+        jobs::parallelFor(count, 64, [&](size_t begin, size_t end) {
+            REQUIRE(begin < end);
+            REQUIRE(end <= count);
+            for (size_t i = begin; i < end; i++) {
+                hits[i]++;
+            }
+        });
+
+        for (auto& hit: hits) {
+            REQUIRE(hit == 1);
+        }
+    }
+}
+
+TEST_CASE("parallelFor nests and repeats", "[jobs]") {
+    std::atomic<size_t> sum = 0;
+    for (int round = 0; round < 50; round++) {
+        jobs::parallelFor(16, 1, [&](size_t begin, size_t end) {
+            jobs::parallelFor(100, 10, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; i++) {
+                    sum += i;
+                }
+            });
+        });
+    }
+    REQUIRE(sum == 50 * 16 * 4950);
+}
+
+TEST_CASE("chunks start at multiples of grain", "[jobs]") {
+    std::atomic<int> misplaced = 0, items = 0;
+    jobs::parallelFor(1000, 64, [&](size_t begin, size_t end) {
+        misplaced += begin % 64 != 0 || end - begin > 64 || (end - begin < 64 && end != 1000);
+        items += int(end - begin);
+    });
+    REQUIRE(misplaced == 0);
+    REQUIRE(items == 1000);
+}
+
+TEST_CASE("jobs wait on the ones they depend on", "[jobs]") {
+    for (int round = 0; round < 20; round++) {
+        std::atomic<int> produced = 0, early = 0;
+        jobs::counter first, second;
+        for (int i = 0; i < 64; i++) {
+            jobs::spawn(first, [&] { produced++; });
+        }
+        for (int i = 0; i < 16; i++) {
+            jobs::spawn(second, [&] {
+                jobs::wait(first);
+                early += produced != 64;
+            });
+        }
+        jobs::wait(second);
+
+        REQUIRE(first.pending == 0);
+        REQUIRE(early == 0);
+    }
+}
+
+TEST_CASE("jobs spawn jobs", "[jobs]") {
+    std::atomic<int> leaves = 0;
+    jobs::counter done;
+    for (int i = 0; i < 8; i++) {
+        jobs::spawn(done, [&] {
+            jobs::counter inner;
+            for (int k = 0; k < 8; k++) {
+                jobs::spawn(inner, [&] {
+                    jobs::parallelFor(32, 4, [&](size_t begin, size_t end) { leaves += int(end - begin); });
+                });
+            }
+            jobs::wait(inner);
+        });
+    }
+    jobs::wait(done);
+    REQUIRE(leaves == 8 * 8 * 32);
+}
+
+TEST_CASE("the pool restarts with another thread count", "[jobs]") {
+    auto threads = jobs::workerCount();
+    for (size_t count: {size_t(3), size_t(1), threads}) {
+        jobs::setThreads(count);
+        REQUIRE(jobs::workerCount() == count);
+
+        std::atomic<int> items = 0;
+        jobs::parallelFor(1000, 7, [&](size_t begin, size_t end) { items += int(end - begin); });
+        REQUIRE(items == 1000);
+    }
+}
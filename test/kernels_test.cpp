@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "kernels.hpp"
+#include "raster.hpp"
+#include "math/mat.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace sfr;
+
+static std::vector<kernels::isa> available() {
+    std::vector<kernels::isa> ret;
+    for (int i = kernels::SSE41; i <= kernels::detect(); i++) {
+        ret.push_back(kernels::isa(i));
+    }
+    return ret;
+}
+
+TEST_CASE("dispatch can be lowered but not raised", "[kernels]") {
+    auto best = kernels::detect();
+
+    REQUIRE(kernels::select(kernels::SSE41) == kernels::SSE41);
+    REQUIRE(kernels::active() == kernels::SSE41);
+    REQUIRE(kernels::get().target == kernels::SSE41);
+
+    REQUIRE(kernels::select(kernels::AVX512) == best);
+    REQUIRE(kernels::get().target == best);
+    REQUIRE(std::strcmp(kernels::name(kernels::AVX2), "avx2") == 0);
+}
+
+TEST_CASE("every variant matches the reference", "[kernels]") {
+    auto& reference = kernels::get(kernels::SSE41);
+
+    // odd lengths exercise the tails of the wider variants
+    const size_t count = 37;
+    mat4 m;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            m[c][r] = float(c * 4 + r) * 0.37f - 2.1f;
+        }
+    }
+    std::vector<vec3> points;
+    for (size_t i = 0; i < count; i++) {
+        points.push_back(vec3(0.3f * i, 1.f - 0.1f * i, 2.f + 0.07f * i * i));
+    }
+    alignas(16) u8 control[16] = {2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15};
+    std::vector<u32> pixels;
+    for (size_t i = 0; i < 40; i++) {
+        pixels.push_back(0x01020304u * u32(i + 1));
+    }
+
+    for (auto target: available()) {
+        auto& table = kernels::get(target);
+
+        alignas(16) u32 filled[count + 3] = {};
+        table.fill32(filled, 0xDEADBEEF, count);
+        REQUIRE(filled[count - 1] == 0xDEADBEEF);
+        REQUIRE(filled[count] == 0);
+
+        for (bool project: {false, true}) {
+            std::vector<vec4> expected(count), result(count);
+            reference.transformPoints(&m[0][0], &points[0].x, &expected[0].x, count, project, precision::exact);
+            table.transformPoints(&m[0][0], &points[0].x, &result[0].x, count, project, precision::exact);
+            REQUIRE(std::memcmp(expected.data(), result.data(), count * sizeof(vec4)) == 0);
+
+            auto point = m * vec4(points[5], 1.f);
+            REQUIRE(std::abs(expected[5].x - point.x / (project ? point.w : 1.f)) < 0.001f);
+        }
+
+        // the cheaper divides only have to stay within their bounds
+        std::vector<vec4> exact(count);
+        table.transformPoints(&m[0][0], &points[0].x, &exact[0].x, count, true, precision::exact);
+        for (auto divide: {precision::fast, precision::approximate}) {
+            std::vector<vec4> result(count);
+            table.transformPoints(&m[0][0], &points[0].x, &result[0].x, count, true, divide);
+
+            float bound = divide == precision::fast ? 1e-6f : 4e-4f;
+            for (size_t i = 0; i < count; i++) {
+                for (int c = 0; c < 3; c++) {
+                    REQUIRE(std::abs(result[i][c] - exact[i][c]) <= bound * std::abs(exact[i][c]));
+                }
+            }
+        }
+
+        std::vector<u32> expected(pixels.size()), result(pixels.size());
+        reference.shuffle32(pixels.data(), expected.data(), 36, control);
+        table.shuffle32(pixels.data(), result.data(), 36, control);
+        REQUIRE(expected == result);
+        REQUIRE(result[0] == 0x01040302u);
+        REQUIRE(result[36] == 0);
+    }
+}
+
+TEST_CASE("every variant rasterizes the same image", "[kernels]") {
+    const int width = 45, height = 29;
+
+    std::vector<vec3> vertices = {
+        {-3.2f, 1.1f, 0.4f}, {40.7f, 5.3f, 0.1f}, {17.5f, 31.9f, 0.9f},
+        {2.f, 2.f, 0.f}, {30.f, 2.f, 0.f}, {2.f, 20.f, 0.5f},
+        {44.9f, 0.f, 0.2f}, {10.f, 28.9f, 0.2f}, {44.9f, 28.9f, 0.2f},
+    };
+    std::vector<u32> indices  = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<color> colors = {color(255, 0, 0), color(0, 255, 0), color(0, 0, 255)};
+
+    std::vector<u32> reference;
+    for (auto target: available()) {
+        kernels::select(target);
+
+        auto colorTex = texture::create(width, height, texture::Color, texture::BGRA8);
+        auto depthTex = texture::create(width, height, texture::Depth);
+        raster::target_data frame{&colorTex, &depthTex, nullptr};
+        raster::drawTriangles(frame, vertices, indices, colors);
+
+        auto* data = static_cast<u32*>(colorTex.data);
+        std::vector<u32> image(data, data + colorTex.stride * height);
+        if (target == kernels::SSE41) {
+            reference = image;
+        }
+        REQUIRE(image == reference);
+
+        // depth first then an equal test, from the same set up triangles
+        texture::clear(colorTex, color{});
+        texture::clear(depthTex, vec3(1.f));
+        auto triangles = raster::setupTriangles(vertices, indices, {0, 0, width, height});
+        raster::drawDepth(frame, triangles);
+        raster::drawTriangles(frame, triangles, colors, true);
+        REQUIRE(std::vector<u32>(data, data + colorTex.stride * height) == reference);
+
+        texture::destroy(colorTex);
+        texture::destroy(depthTex);
+    }
+    kernels::select(kernels::detect());
+}
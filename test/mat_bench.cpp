@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench.hpp"
+#include "math/mat.hpp"
+#include "math/quat.hpp"
+#include "math/vec.hpp"
+#include "math/wide.hpp"
+
+#include <span>
+#include <string>
+
+using bench::Count;
+
+// Rotation, scale and translation, so the affine inverse applies as well.
+template <size_t Size>
+static std::span<mat<float, Size>> sampleMatrices(bench::arrays& memory) {
+    auto ret = memory.make<mat<float, Size>>(Count);
+    for (size_t i = 0; i < Count; i++) {
+        auto& m = ret[i];
+        m       = mat<float, Size>(1.f + 0.01f * i);
+        m[1][0] = 0.1f;
+        m[0][1] = -0.2f;
+        m[Size - 1][0] = 0.5f * i;
+        m[Size - 1][1] = -0.25f * i;
+    }
+    return ret;
+}
+
+template <size_t Size>
+static std::span<vec<float, Size>> sampleVectors(bench::arrays& memory) {
+    auto ret = memory.make<vec<float, Size>>(Count);
+    for (size_t i = 0; i < Count; i++) {
+        for (size_t c = 0; c < Size; c++) {
+            ret[i][c] = 1.f + 0.5f * c + 0.01f * i;
+        }
+    }
+    return ret;
+}
+
+// Every operator of mat<float, Size>, one row each.
+template <size_t Size>
+static void benchmarkMat(const std::string& name) {
+    auto& suite = bench::baselines();
+
+    bench::arrays memory;
+    auto a       = sampleMatrices<Size>(memory);
+    auto b       = sampleMatrices<Size>(memory);
+    auto v       = sampleVectors<Size>(memory);
+    auto out     = memory.make<mat<float, Size>>(Count);
+    auto vectors = memory.make<vec<float, Size>>(Count);
+    auto scalars = memory.make<float>(Count);
+
+    auto row = [&](const std::string& op, auto&& body) {
+        suite.run(name + " " + op, [&] {
+            for (size_t i = 0; i < Count; i++) {
+                body(i);
+            }
+            bench::keep(out);
+            bench::keep(vectors);
+            bench::keep(scalars);
+        });
+    };
+
+    row("+", [&](size_t i) { out[i] = a[i] + b[i]; });
+    row("-", [&](size_t i) { out[i] = a[i] - b[i]; });
+    row("*", [&](size_t i) { out[i] = a[i] * b[i]; });
+    row("*=", [&](size_t i) { (out[i] = a[i]) *= b[i]; });
+    row("* vec", [&](size_t i) { vectors[i] = a[i] * v[i]; });
+    row("transpose", [&](size_t i) { out[i] = transpose(a[i]); });
+    if constexpr (Size == 3) {
+        row("det", [&](size_t i) { scalars[i] = det(a[i]); });
+    }
+    if constexpr (Size == 4) {
+        row("inverse", [&](size_t i) { out[i] = inverse(a[i]); });
+        row("affine inverse", [&](size_t i) { out[i] = affineInverse(a[i]); });
+    }
+}
+
+// The batch forms, one matrix over Count vectors.
+template <size_t Size>
+static void benchmarkMatBatch(const std::string& name) {
+    using wide_type = wide_vec<float, Size, 8>;
+    const size_t batches = Count / 8;
+
+    auto& suite = bench::baselines();
+
+    bench::arrays memory;
+    auto m       = sampleMatrices<Size>(memory)[7];
+    auto vectors = sampleVectors<Size>(memory);
+    auto in      = memory.make<wide_type>(batches);
+    auto out     = memory.make<wide_type>(batches);
+    for (size_t i = 0; i < batches; i++) {
+        in[i] = wide_type::load(&vectors[i * 8]);
+    }
+
+    suite.run(name + " * vec x8", [&] {
+        for (size_t i = 0; i < batches; i++) {
+            out[i] = m * in[i];
+        }
+        bench::keep(out);
+    });
+}
+
+TEST_CASE("mat3 throughput", "[math][bench]") {
+    benchmarkMat<3>("mat3");
+    benchmarkMatBatch<3>("mat3");
+}
+
+TEST_CASE("mat4 throughput", "[math][bench]") {
+    benchmarkMat<4>("mat4");
+    benchmarkMatBatch<4>("mat4");
+
+    bench::arrays memory;
+    auto m      = sampleMatrices<4>(memory)[7];
+    auto points = sampleVectors<3>(memory);
+    auto out    = memory.make<vec4>(Count);
+    bench::baselines().run("mat4 batch transform", [&] {
+        transform(m, std::span<const vec3>(points), out);
+        bench::keep(out);
+    });
+}
+
+TEST_CASE("quat throughput", "[math][bench]") {
+    auto& suite = bench::baselines();
+
+    bench::arrays memory;
+    auto points = sampleVectors<3>(memory);
+    auto out    = memory.make<vec3>(Count);
+    auto q      = memory.make<quat>(Count);
+    auto p      = memory.make<quat>(Count);
+    auto qOut   = memory.make<quat>(Count);
+    auto a      = memory.make<dualquat>(Count);
+    auto b      = memory.make<dualquat>(Count);
+    auto dqOut  = memory.make<dualquat>(Count);
+    for (size_t i = 0; i < Count; i++) {
+        q[i] = angleAxis(0.5f * i, normalize(points[i]));
+        p[i] = angleAxis(-0.25f * i, vec3(0.f, 1.f, 0.f));
+        a[i] = dualquat(q[i], points[i]);
+        b[i] = dualquat(p[i], -1.f * points[i]);
+    }
+
+    auto row = [&](const char* name, auto&& body) {
+        suite.run(name, [&] {
+            for (size_t i = 0; i < Count; i++) {
+                body(i);
+            }
+            bench::keep(out);
+            bench::keep(qOut);
+            bench::keep(dqOut);
+        });
+    };
+
+    row("quat *", [&](size_t i) { qOut[i] = q[i] * p[i]; });
+    row("quat rotate", [&](size_t i) { out[i] = rotate(q[i], points[i]); });
+    row("quat nlerp", [&](size_t i) { qOut[i] = nlerp(q[i], p[i], 0.3f); });
+    row("dualquat *", [&](size_t i) { dqOut[i] = a[i] * b[i]; });
+    row("dualquat normalize fast", [&](size_t i) { dqOut[i] = normalize<precision::fast>(a[i]); });
+    row("dualquat transform point", [&](size_t i) { out[i] = transformPoint(a[i], points[i]); });
+}
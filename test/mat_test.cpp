@@ -1,8 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "math/mat.hpp"
+#include "math/transform.hpp"
 #include "math/vec.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 TEST_CASE("mat3 addition", "[math]") {
     mat3 a(1.f);
     mat3 b(2.f);
@@ -140,3 +145,119 @@ TEST_CASE("vec4-mat4 multiplication", "[math]") {
     vec4 baseline(3.0f, 2.0f, 4.0f, 1.0f);
     REQUIRE(res == baseline);
 }
+
+static mat4 sampleMatrix() {
+    mat4 m;
+    const float values[16] = {
+        2.f, 0.5f, -1.f, 0.25f,
+        0.3f, 3.f, 0.7f, -0.5f,
+        -1.2f, 0.4f, 1.5f, 0.1f,
+        4.f, -2.f, 0.5f, 1.f,
+    };
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            m[c][r] = values[c * 4 + r];
+        }
+    }
+    return m;
+}
+
+static mat4 sampleAffine() {
+    mat4 m(0.f);
+    m[0][0] = 0.8f;
+    m[0][1] = 0.6f;
+    m[1][0] = -1.2f;
+    m[1][1] = 1.6f;
+    m[2][2] = 0.5f;
+    m[3][0] = 3.f;
+    m[3][1] = -7.f;
+    m[3][2] = 11.f;
+    m[3][3] = 1.f;
+    return m;
+}
+
+static float maxError(const mat4& a, const mat4& b) {
+    float error = 0.f;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            error = std::max(error, std::abs(a[c][r] - b[c][r]));
+        }
+    }
+    return error;
+}
+
+TEST_CASE("mat4 transpose", "[math]") {
+    auto m   = sampleMatrix();
+    auto res = transpose(m);
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            REQUIRE(res[c][r] == m[r][c]);
+        }
+    }
+    REQUIRE(maxError(transpose(res), m) == 0.f);
+}
+
+TEST_CASE("mat4 inverse", "[math]") {
+    auto m   = sampleMatrix();
+    auto inv = inverse(m);
+
+    // a few ulps of the largest entry on either side
+    REQUIRE(maxError(m * inv, mat4(1.f)) < 1e-5f);
+    REQUIRE(maxError(inv * m, mat4(1.f)) < 1e-5f);
+    REQUIRE(maxError(inverse(inv), m) < 1e-5f);
+    REQUIRE(maxError(inverse(mat4(1.f)), mat4(1.f)) < 1e-6f);
+}
+
+TEST_CASE("mat4 affine inverse", "[math]") {
+    auto m   = sampleAffine();
+    auto inv = affineInverse(m);
+
+    REQUIRE(maxError(m * inv, mat4(1.f)) < 1e-5f);
+    REQUIRE(maxError(inv, inverse(m)) < 1e-5f);
+    REQUIRE(inv[3][3] == 1.f);
+    REQUIRE(inv[0][3] == 0.f);
+}
+
+TEST_CASE("mat4 batch transform", "[math]") {
+    auto m = sampleMatrix();
+
+    std::vector<vec3> points;
+    for (int i = 0; i < 9; i++) {
+        points.push_back(vec3(0.5f * i, 1.f - i, 0.25f * i * i));
+    }
+    std::vector<vec4> out(points.size());
+    transform(m, std::span<const vec3>(points), std::span<vec4>(out));
+
+    for (size_t i = 0; i < points.size(); i++) {
+        auto expected = m * vec4(points[i], 1.f);
+        for (int c = 0; c < 4; c++) {
+            REQUIRE(std::abs(out[i][c] - expected[c]) < 1e-5f * std::max(1.f, std::abs(expected[c])));
+        }
+    }
+}
+
+TEST_CASE("transform builders fold at compile time", "[math]") {
+    constexpr auto vp = viewport({-1.f, -1.f, 2.f, 2.f}, {0.f, 0.f, 1280.f, 720.f});
+    static_assert(vp[0][0] == 640.f);
+    static_assert(vp[3][1] == 360.f);
+
+    constexpr auto moved = translate({1.f, 2.f, 3.f}) * scale({2.f, 2.f, 2.f});
+    static_assert(moved[3][2] == 3.f && moved[1][1] == 2.f);
+
+    constexpr auto eye = view(vec3(1.f, -2.f, 5.f), vec3(0.f, 0.f, 1.f), vec3(1.f, 0.f, 0.f), vec3(0.f, 1.f, 0.f));
+    static_assert(eye[3][0] == -1.f && eye[3][1] == 2.f && eye[3][2] == -5.f);
+
+    // view folds the translation into the rotation, the same as the full product
+    vec3 position(1.f, -2.f, 5.f);
+    vec3 forward(0.f, 0.6f, -0.8f);
+    vec3 right(1.f, 0.f, 0.f);
+    vec3 up(0.f, 0.8f, 0.6f);
+
+    auto rotation = mat4(1.f);
+    for (int i = 0; i < 3; i++) {
+        rotation[i][0] = right[i];
+        rotation[i][1] = up[i];
+        rotation[i][2] = forward[i];
+    }
+    REQUIRE(maxError(view(position, forward, right, up), rotation * translate(-1 * position)) < 1e-5f);
+}
@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench.hpp"
+#include "occlusion.hpp"
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace sfr;
+using bench::Count;
+
+// Box tests against a 1280x720 buffer behind one large wall, boxes from a couple of pixels, tested
+// pixel by pixel, up to hundreds, tested against the coarse level.
+TEST_CASE("occlusion box tests", "[occlusion][bench]") {
+    auto& suite = bench::baselines();
+
+    auto buffer = occlusion::create(1280, 720);
+    std::vector<vec3> wall = {{100.f, 50.f, 0.5f}, {1200.f, 50.f, 0.5f}, {1200.f, 700.f, 0.5f}, {100.f, 700.f, 0.5f}};
+    occlusion::addOccluders(buffer, wall, {0, 1, 2, 0, 2, 3});
+    occlusion::finish(buffer);
+
+    auto boxes = [](float minSize, float maxSize) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> x(0.f, 1280.f), y(0.f, 720.f), size(minSize, maxSize);
+        std::vector<vec3> ret;
+        for (size_t i = 0; i < Count; i++) {
+            auto lo = vec3(x(rng), y(rng), 0.6f);
+            ret.push_back(lo);
+            ret.push_back(lo + vec3(size(rng), size(rng), 0.1f));
+        }
+        return ret;
+    };
+
+    int visible = 0;
+    for (auto [name, minSize, maxSize]: {std::tuple{"visible small boxes", 2.f, 24.f}, {"visible large boxes", 64.f, 400.f}}) {
+        auto tested = boxes(minSize, maxSize);
+        suite.run(name, [&] {
+            for (size_t i = 0; i < tested.size(); i += 2) {
+                visible += occlusion::visible(buffer, tested[i], tested[i + 1]);
+            }
+        });
+    }
+
+    bench::keep(visible);
+}
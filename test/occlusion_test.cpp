@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "occlusion.hpp"
+#include "raster.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace sfr;
+
+static const int Width = 256, Height = 160;
+
+// a wall over screen pixels 40 to 200 and 40 to 120, at depth 0.5
+static const std::vector<vec3> wall = {{40.f, 40.f, 0.5f}, {200.f, 40.f, 0.5f}, {200.f, 120.f, 0.5f}, {40.f, 120.f, 0.5f}};
+static const std::vector<u32> wallIndices = {0, 1, 2, 0, 2, 3};
+
+TEST_CASE("boxes behind an occluder are culled", "[occlusion]") {
+    auto buffer = occlusion::create(Width, Height);
+    occlusion::addOccluders(buffer, wall, wallIndices);
+    occlusion::finish(buffer);
+
+    // small boxes go pixel by pixel
+    REQUIRE_FALSE(occlusion::visible(buffer, vec3(60.f, 60.f, 0.6f), vec3(100.f, 70.f, 0.7f)));
+    REQUIRE(occlusion::visible(buffer, vec3(60.f, 60.f, 0.4f), vec3(100.f, 70.f, 0.7f)));
+    REQUIRE(occlusion::visible(buffer, vec3(180.f, 60.f, 0.6f), vec3(220.f, 70.f, 0.7f)));
+    // partly covered buffer pixels along the edges hide nothing
+    REQUIRE(occlusion::visible(buffer, vec3(38.f, 60.f, 0.6f), vec3(50.f, 70.f, 0.7f)));
+
+    // large ones against the blocks
+    REQUIRE_FALSE(occlusion::visible(buffer, vec3(64.f, 64.f, 0.6f), vec3(191.f, 95.f, 0.9f)));
+    REQUIRE(occlusion::visible(buffer, vec3(64.f, 64.f, 0.4f), vec3(191.f, 95.f, 0.9f)));
+    REQUIRE(occlusion::visible(buffer, vec3(0.f, 0.f, 0.6f), vec3(255.f, 159.f, 0.9f)));
+
+    // off screen
+    REQUIRE_FALSE(occlusion::visible(buffer, vec3(-50.f, 10.f, 0.1f), vec3(-10.f, 20.f, 0.2f)));
+
+    occlusion::clear(buffer);
+    occlusion::finish(buffer);
+    REQUIRE(occlusion::visible(buffer, vec3(60.f, 60.f, 0.6f), vec3(100.f, 70.f, 0.7f)));
+}
+
+TEST_CASE("culled boxes are hidden at full resolution", "[occlusion]") {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> x(-20.f, Width + 20.f), y(-20.f, Height + 20.f), z(0.f, 1.f);
+
+    std::vector<vec3> occluders;
+    std::vector<u32> indices;
+    for (u32 i = 0; i < 24; i++) {
+        occluders.push_back(vec3(x(rng), y(rng), z(rng)));
+        indices.push_back(i);
+    }
+
+    auto buffer = occlusion::create(Width, Height);
+    occlusion::addOccluders(buffer, occluders, indices);
+    occlusion::finish(buffer);
+
+    auto colorTex = texture::create(Width, Height, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(Width, Height, texture::Depth);
+    raster::target_data target{&colorTex, &depthTex, nullptr};
+    raster::drawTriangles(target, occluders, indices, {color(255, 255, 255)});
+
+    int culled = 0;
+    for (int i = 0; i < 2000; i++) {
+        auto a = vec3(x(rng), y(rng), z(rng));
+        auto b = a + vec3(std::abs(x(rng)) * 0.3f, std::abs(y(rng)) * 0.3f, 0.1f);
+        if (occlusion::visible(buffer, a, b)) {
+            continue;
+        }
+        culled++;
+
+        for (int py = std::max(0, int(std::floor(a.y))); py <= std::min(Height - 1, int(std::floor(b.y))); py++) {
+            for (int px = std::max(0, int(std::floor(a.x))); px <= std::min(Width - 1, int(std::floor(b.x))); px++) {
+                REQUIRE(texture::getDepth(depthTex, px, py) < a.z);
+            }
+        }
+    }
+    REQUIRE(culled > 0);
+
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+}
+
+TEST_CASE("boxes beside an occluder stay visible", "[occlusion]") {
+    auto buffer = occlusion::create(1280, 720);
+    std::vector<vec3> screen = {{100.f, 50.f, 0.5f}, {1200.f, 50.f, 0.5f}, {1200.f, 700.f, 0.5f}, {100.f, 700.f, 0.5f}};
+    occlusion::addOccluders(buffer, screen, wallIndices);
+    occlusion::finish(buffer);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> x(0.f, 1280.f), y(0.f, 720.f), size(2.f, 400.f);
+    int visible = 0, hidden = 0;
+    for (int i = 0; i < 10000; i++) {
+        auto lo = vec3(x(rng), y(rng), 0.6f);
+        auto hi = lo + vec3(size(rng), size(rng), 0.1f);
+        (occlusion::visible(buffer, lo, hi) ? visible : hidden)++;
+    }
+
+    // timings are in test/occlusion_bench.cpp
+    INFO(visible << " visible, " << hidden << " hidden");
+    REQUIRE(visible > 0);
+    REQUIRE(hidden > 0);
+}
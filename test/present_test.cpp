@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "present.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace sfr;
+
+static void renderFrame(texture::texture_data& frame, int index) {
+    texture::clear(frame, color(index, index * 3, index * 7));
+    texture::setPixel(frame, index % frame.width, 0, color(255, 255, 255));
+}
+
+TEST_CASE("present delivers every frame in order", "[present]") {
+    const int frameCount = 16;
+
+    for (int bufferCount = 1; bufferCount <= present::MaxBuffers; bufferCount++) {
+        present::null_target target{};
+        auto chain = present::create(present::nullBackend(target), 32, 16, bufferCount);
+
+        present::null_target reference{};
+        auto serial = present::nullBackend(reference);
+        auto frame  = texture::create(32, 16, texture::Color, chain.format);
+
+        for (int i = 0; i < frameCount; i++) {
+            renderFrame(present::acquire(chain), i);
+            present::submit(chain);
+
+            renderFrame(frame, i);
+            serial.present(serial.user, frame);
+        }
+        present::flush(chain);
+
+        REQUIRE(target.frames == frameCount);
+        REQUIRE(target.checksum == reference.checksum);
+
+        texture::destroy(frame);
+        present::destroy(chain);
+    }
+}
+
+TEST_CASE("present overlaps rendering with hand-off", "[present]") {
+    using clock = std::chrono::steady_clock;
+
+    const int frameCount = 20;
+    const auto rasterCost = std::chrono::milliseconds(10);
+
+    present::null_target target{};
+    target.delayMicros = 10000;
+    auto chain = present::create(present::nullBackend(target), 32, 16, 2);
+
+    auto start = clock::now();
+    for (int i = 0; i < frameCount; i++) {
+        auto& frame = present::acquire(chain);
+        std::this_thread::sleep_for(rasterCost);
+        renderFrame(frame, i);
+        present::submit(chain);
+    }
+    present::flush(chain);
+    auto elapsed = clock::now() - start;
+
+    // serial raster + present would take frameCount * 20ms
+    REQUIRE(target.frames == frameCount);
+    REQUIRE(elapsed < frameCount * rasterCost * 2 * 3 / 4);
+
+    present::destroy(chain);
+}
+
+TEST_CASE("present renders into backend provided storage", "[present]") {
+    const size_t width = 32, height = 16;
+    const auto frameBytes = texture::byteSize(width, height, texture::BGRA8);
+
+    std::vector<u8> ring(frameBytes * 3);
+    present::null_target target{};
+    auto backend    = present::nullBackend(target);
+    backend.storage = ring.data();
+    auto chain      = present::create(backend, width, height, 3);
+
+    present::null_target reference{};
+    auto serial = present::nullBackend(reference);
+    auto frame  = texture::create(width, height, texture::Color, chain.format);
+
+    for (int i = 0; i < 6; i++) {
+        auto& acquired = present::acquire(chain);
+        auto offset    = static_cast<u8*>(acquired.data) - ring.data();
+        REQUIRE(offset % frameBytes == 0);
+        REQUIRE(offset / frameBytes < 3);
+
+        renderFrame(acquired, i);
+        present::submit(chain);
+
+        renderFrame(frame, i);
+        serial.present(serial.user, frame);
+    }
+    present::flush(chain);
+    REQUIRE(target.frames == 6);
+    REQUIRE(target.checksum == reference.checksum);
+
+    // wrapped buffers are left to their owner, the last frame is still in its slot
+    present::destroy(chain);
+    auto last = texture::wrap(ring.data() + 5 % 3 * frameBytes, width, height, texture::Color, texture::BGRA8);
+    REQUIRE(texture::getPixel(last, 5, 0) == color(255, 255, 255));
+    REQUIRE(texture::getPixel(last, 0, 1) == color(5, 15, 35));
+
+    texture::destroy(frame);
+}
+
+struct reclaim_target {
+    int frames;
+    std::vector<const void*> reclaimed;
+};
+
+TEST_CASE("presented buffers are reclaimed only once the renderer runs out", "[present]") {
+    reclaim_target target{};
+    present::backend backend{&target, nullptr, nullptr, nullptr};
+    backend.present = [](void* user, const texture::texture_data&) { static_cast<reclaim_target*>(user)->frames++; };
+    backend.reclaim = [](void* user, const texture::texture_data& frame) {
+        static_cast<reclaim_target*>(user)->reclaimed.push_back(frame.data);
+    };
+    auto chain = present::create(backend, 32, 16, 3);
+
+    std::vector<const void*> acquired;
+    for (int i = 0; i < 8; i++) {
+        auto& frame = present::acquire(chain);
+        // every buffer past the first three went through reclaim right before
+        if (i >= 3) {
+            REQUIRE(target.reclaimed.size() == size_t(i - 2));
+            REQUIRE(target.reclaimed.back() == frame.data);
+        }
+        renderFrame(frame, i);
+        present::submit(chain);
+    }
+    present::flush(chain);
+    REQUIRE(target.frames == 8);
+
+    present::destroy(chain);
+}
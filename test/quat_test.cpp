@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "math/mat.hpp"
+#include "math/quat.hpp"
+#include "math/transform.hpp"
+#include "math/vec.hpp"
+
+#include <cmath>
+
+static bool near(const vec3& u, const vec3& v, float eps = 1e-5f) {
+    return std::abs(u.x - v.x) < eps && std::abs(u.y - v.y) < eps && std::abs(u.z - v.z) < eps;
+}
+
+TEST_CASE("quat rotation matches the euler matrices", "[math]") {
+    auto p = vec3(0.3f, -1.2f, 2.5f);
+
+    auto qx = angleAxis(30.f, vec3(1.f, 0.f, 0.f));
+    auto qy = angleAxis(-45.f, vec3(0.f, 1.f, 0.f));
+    auto qz = angleAxis(110.f, vec3(0.f, 0.f, 1.f));
+    REQUIRE(near(rotate(qx, p), vec3(rotateOX(30.f) * vec4(p, 1.f))));
+    REQUIRE(near(rotate(qy, p), vec3(rotateOY(-45.f) * vec4(p, 1.f))));
+    REQUIRE(near(rotate(qz, p), vec3(rotateOZ(110.f) * vec4(p, 1.f))));
+
+    // q * p rotates by p first
+    auto m = rotateOZ(110.f) * rotateOY(-45.f) * rotateOX(30.f);
+    auto q = qz * qy * qx;
+    REQUIRE(near(rotate(q, p), vec3(m * vec4(p, 1.f))));
+    REQUIRE(near(vec3(rotate(q) * vec4(p, 1.f)), vec3(m * vec4(p, 1.f))));
+
+    REQUIRE(std::abs(dot(q, q) - 1.f) < 1e-5f);
+    REQUIRE(near(rotate(conjugate(q), rotate(q, p)), p));
+    REQUIRE(near(rotate(quat::identity(), p), p));
+}
+
+TEST_CASE("quat nlerp takes the short way", "[math]") {
+    auto a = angleAxis(10.f, vec3(0.f, 1.f, 0.f));
+    auto b = angleAxis(50.f, vec3(0.f, 1.f, 0.f));
+    auto p = vec3(1.f, 0.f, 0.f);
+
+    auto half = angleAxis(30.f, vec3(0.f, 1.f, 0.f));
+    REQUIRE(near(rotate(nlerp(a, b, 0.5f), p), rotate(half, p)));
+    // -b is the same rotation, the blend must not swing the long way round
+    REQUIRE(near(rotate(nlerp(a, -1.f * b, 0.5f), p), rotate(half, p)));
+    REQUIRE(near(rotate(nlerp(a, b, 0.f), p), rotate(a, p)));
+
+    auto n = normalize(2.f * a);
+    REQUIRE(std::abs(dot(n, n) - 1.f) < 1e-6f);
+    n = normalize<precision::fast>(2.f * a);
+    REQUIRE(std::abs(dot(n, n) - 1.f) < 1e-5f);
+}
+
+TEST_CASE("dualquat rigid transforms", "[math]") {
+    auto rotation    = angleAxis(70.f, normalize(vec3(1.f, 2.f, -1.f)));
+    auto offset      = vec3(4.f, -2.f, 0.5f);
+    auto dq          = dualquat(rotation, offset);
+    auto p           = vec3(-1.f, 0.25f, 3.f);
+
+    REQUIRE(near(translation(dq), offset));
+    REQUIRE(near(transformPoint(dq, p), rotate(rotation, p) + offset));
+    REQUIRE(near(vec3(rotateTranslate(dq) * vec4(p, 1.f)), transformPoint(dq, p)));
+
+    // a * b applies b first
+    auto other = dualquat(angleAxis(-20.f, vec3(0.f, 0.f, 1.f)), vec3(0.f, 1.f, 0.f));
+    REQUIRE(near(transformPoint(dq * other, p), transformPoint(dq, transformPoint(other, p)), 1e-4f));
+    REQUIRE(near(transformPoint(dualquat::identity(), p), p));
+
+    // an even blend of a transform with itself is the transform again once normalized
+    auto blend = normalize(0.25f * dq + 0.75f * dq);
+    REQUIRE(near(transformPoint(blend, p), transformPoint(dq, p)));
+}
@@ -0,0 +1,486 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "raster.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace sfr;
+
+// target points into the frame itself, so frames are never copied or moved, only built in place
+struct frame {
+    texture::texture_data color;
+    texture::texture_data depth;
+    raster::target_data target;
+
+    frame(size_t width, size_t height)
+        : color(texture::create(width, height, texture::Color, texture::BGRA8)),
+          depth(texture::create(width, height, texture::Depth)),
+          target{&color, &depth, nullptr} {}
+    frame(const frame&) = delete;
+    frame& operator=(const frame&) = delete;
+};
+
+static frame createFrame(size_t width, size_t height) {
+    return frame(width, height);
+}
+
+static void destroyFrame(frame& f) {
+    texture::destroy(f.color);
+    texture::destroy(f.depth);
+}
+
+static int countColored(texture::texture_data& tex) {
+    int count = 0;
+    for (int y = 0; y < tex.height; y++) {
+        for (int x = 0; x < tex.width; x++) {
+            auto col = texture::getPixel(tex, x, y);
+            count += col.r || col.g || col.b;
+        }
+    }
+    return count;
+}
+
+TEST_CASE("shared edges are filled exactly once", "[raster]") {
+    auto f = createFrame(16, 16);
+
+    // one square split along the diagonal, both windings
+    std::vector<vec3> vertices = {{2, 2, 0}, {10, 2, 0}, {10, 10, 0}, {2, 10, 0}};
+    std::vector<u32> indices   = {0, 1, 2, 0, 3, 2};
+    raster::drawTriangles(f.target, vertices, indices, {color(255, 0, 0)});
+
+    REQUIRE(countColored(f.color) == 64);
+    REQUIRE(texture::getPixel(f.color, 2, 2).r == 255);
+    REQUIRE(texture::getPixel(f.color, 9, 9).r == 255);
+    REQUIRE(texture::getPixel(f.color, 10, 10).r == 0);
+
+    destroyFrame(f);
+}
+
+TEST_CASE("nearer triangles win the depth test", "[raster]") {
+    auto f = createFrame(8, 8);
+
+    std::vector<vec3> vertices = {
+        {0, 0, 0.5f}, {8, 0, 0.5f}, {0, 8, 0.5f},
+        {0, 0, -0.5f}, {8, 0, -0.5f}, {0, 8, -0.5f},
+    };
+    std::vector<u32> indices  = {3, 4, 5, 0, 1, 2};
+    std::vector<color> colors = {color(0, 255, 0), color(255, 0, 0)};
+    raster::drawTriangles(f.target, vertices, indices, colors);
+
+    auto col = texture::getPixel(f.color, 1, 1);
+    REQUIRE(col.g == 255);
+    REQUIRE(col.r == 0);
+    REQUIRE(texture::getDepth(f.depth, 1, 1) == -0.5f);
+
+    destroyFrame(f);
+}
+
+TEST_CASE("msaa keeps interior pixels compressed", "[raster][msaa]") {
+    for (int samples: {4, 8}) {
+        auto f    = createFrame(16, 8);
+        auto msaa = msaa::create(16, 8, samples, texture::BGRA8);
+        f.target.msaa = &msaa;
+
+        // vertical edge through the pixel centers of column 4
+        std::vector<vec3> vertices = {{4.5f, -1, 0}, {20, -1, 0}, {4.5f, 20, 0}, {20, 20, 0}};
+        std::vector<u32> indices   = {0, 1, 2, 1, 3, 2};
+        raster::drawTriangles(f.target, vertices, indices, {color(255, 255, 255)});
+        msaa::resolve(msaa, f.color);
+
+        REQUIRE(msaa.uniform[2 * msaa.stride + 8] == 1);
+        REQUIRE(msaa.uniform[2 * msaa.stride + 4] == 0);
+        REQUIRE(msaa.uniform[2 * msaa.stride + 1] == 1);
+
+        REQUIRE(texture::getPixel(f.color, 8, 2).r == 255);
+        REQUIRE(texture::getPixel(f.color, 1, 2).r == 0);
+        // half of the samples lie right of the pixel center
+        auto edge = texture::getPixel(f.color, 4, 2).r;
+        REQUIRE(edge >= 127);
+        REQUIRE(edge <= 128);
+
+        msaa::destroy(msaa);
+        destroyFrame(f);
+    }
+}
+
+TEST_CASE("msaa edges match supersampling", "[raster][msaa]") {
+    const int size = 32;
+
+    auto f    = createFrame(size, size);
+    auto msaa = msaa::create(size, size, 4, texture::BGRA8);
+    f.target.msaa = &msaa;
+
+    std::vector<vec3> vertices = {{1.3f, 2.1f, 0}, {30.2f, 7.7f, 0}, {11.6f, 29.4f, 0}};
+    std::vector<u32> indices   = {0, 1, 2};
+    raster::drawTriangles(f.target, vertices, indices, {color(255, 255, 255)});
+    msaa::resolve(msaa, f.color);
+
+    // 4x supersampled reference, rendered at twice the resolution and box filtered
+    auto big = createFrame(size * 2, size * 2);
+    std::vector<vec3> scaled;
+    for (auto& v: vertices) {
+        scaled.push_back(vec3(v.x * 2, v.y * 2, 0));
+    }
+    raster::drawTriangles(big.target, scaled, indices, {color(255, 255, 255)});
+
+    int totalError = 0;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int reference = 0;
+            for (int s = 0; s < 4; s++) {
+                reference += texture::getPixel(big.color, x * 2 + s % 2, y * 2 + s / 2).r;
+            }
+            totalError += std::abs(reference / 4 - texture::getPixel(f.color, x, y).r);
+        }
+    }
+    // on average within a couple of levels per pixel
+    REQUIRE(totalError < size * size * 4);
+
+    msaa::destroy(msaa);
+    destroyFrame(f);
+    destroyFrame(big);
+}
+
+TEST_CASE("a depth pre-pass shades the same image", "[raster]") {
+    const int width = 37, height = 23;
+
+    // two triangles cutting through each other and a third partly behind both
+    std::vector<vec3> vertices = {
+        {1.2f, 0.7f, 0.1f}, {35.6f, 4.3f, 0.9f}, {8.1f, 22.4f, 0.5f},
+        {2.5f, 20.9f, 0.8f}, {30.3f, 1.1f, 0.2f}, {34.7f, 21.8f, 0.4f},
+        {-4.f, 10.f, 0.3f}, {40.f, 9.f, 0.3f}, {18.f, -3.f, 0.3f},
+    };
+    std::vector<u32> indices  = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<color> colors = {color(255, 0, 0), color(0, 255, 0), color(0, 0, 255)};
+
+    for (auto format: {texture::BGRA8, texture::RGBA8}) {
+        auto single = texture::create(width, height, texture::Color, format);
+        auto shaded = texture::create(width, height, texture::Color, format);
+        auto depthA = texture::create(width, height, texture::Depth);
+        auto depthB = texture::create(width, height, texture::Depth);
+        texture::clear(depthA, vec3(1.f));
+        texture::clear(depthB, vec3(1.f));
+
+        raster::target_data reference{&single, &depthA, nullptr};
+        raster::drawTriangles(reference, vertices, indices, colors);
+
+        raster::target_data target{&shaded, &depthB, nullptr};
+        auto triangles = raster::setupTriangles(vertices, indices, {0, 0, width, height});
+        raster::drawDepth(target, triangles);
+        raster::drawTriangles(target, triangles, colors, true);
+
+        int seen[3] = {};
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                auto a = texture::getPixel(single, x, y);
+                auto b = texture::getPixel(shaded, x, y);
+                REQUIRE(a.r == b.r);
+                REQUIRE(a.g == b.g);
+                REQUIRE(a.b == b.b);
+                REQUIRE(texture::getDepth(depthA, x, y) == texture::getDepth(depthB, x, y));
+                seen[0] += b.r != 0;
+                seen[1] += b.g != 0;
+                seen[2] += b.b != 0;
+            }
+        }
+        // every triangle is in front somewhere
+        REQUIRE(seen[0] > 0);
+        REQUIRE(seen[1] > 0);
+        REQUIRE(seen[2] > 0);
+
+        texture::destroy(single);
+        texture::destroy(shaded);
+        texture::destroy(depthA);
+        texture::destroy(depthB);
+    }
+}
+
+TEST_CASE("large triangles walked in blocks match a row by row fill", "[raster]") {
+    const int width = 203, height = 141;
+
+    // a full screen pair, a slanted plane, a sliver and one past the edges
+    std::vector<vec3> vertices = {
+        {0.f, 0.f, 0.5f}, {203.f, 0.f, 0.5f}, {203.f, 141.f, 0.5f}, {0.f, 141.f, 0.5f},
+        {-40.f, 30.f, 0.9f}, {250.f, 41.3f, 0.9f}, {120.7f, 141.f, 0.05f},
+        {3.3f, 2.1f, 0.2f}, {199.6f, 137.4f, 0.3f}, {7.9f, 2.2f, 0.25f},
+        {-100.f, -80.f, 0.7f}, {300.f, 12.5f, 0.1f}, {61.25f, 400.f, 0.4f},
+    };
+    std::vector<u32> indices  = {0, 1, 2, 0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    std::vector<color> colors = {color(255, 0, 0), color(0, 255, 0), color(0, 0, 255), color(255, 255, 0)};
+    auto triangles            = raster::setupTriangles(vertices, indices, {0, 0, width, height});
+
+    auto blocks = createFrame(width, height);
+    auto rows   = createFrame(width, height);
+    auto depth  = texture::create(width, height, texture::Depth);
+    texture::clear(blocks.depth, vec3(1.f));
+    texture::clear(rows.depth, vec3(1.f));
+    texture::clear(depth, vec3(1.f));
+    raster::drawTriangles(blocks.target, triangles, colors);
+    raster::target_data depthOnly{nullptr, &depth, nullptr};
+    raster::drawDepth(depthOnly, triangles);
+
+    auto& kernels = kernels::get();
+    auto* colorsB = static_cast<u32*>(rows.color.data);
+    auto* depthsB = static_cast<float*>(rows.depth.data);
+    REQUIRE(triangles.index.size() == 5);
+    for (size_t t = 0; t < triangles.index.size(); t++) {
+        auto minX = triangles.minX[t], maxX = triangles.maxX[t];
+        REQUIRE((maxX - minX + 1) * (triangles.maxY[t] - triangles.minY[t] + 1) >= raster::LargeTriangle);
+        auto packed = texture::pack(colors[triangles.index[t] % colors.size()], texture::BGRA8);
+        for (int y = triangles.minY[t]; y <= triangles.maxY[t]; y++) {
+            auto row = y * rows.color.stride;
+            kernels.fillRow(triangles.edges[t], y, minX, maxX, &depthsB[row], &colorsB[row], packed, false);
+        }
+    }
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            REQUIRE(texture::getPixel(blocks.color, x, y).r == texture::getPixel(rows.color, x, y).r);
+            REQUIRE(texture::getPixel(blocks.color, x, y).g == texture::getPixel(rows.color, x, y).g);
+            REQUIRE(texture::getPixel(blocks.color, x, y).b == texture::getPixel(rows.color, x, y).b);
+            REQUIRE(texture::getDepth(blocks.depth, x, y) == texture::getDepth(rows.depth, x, y));
+            REQUIRE(texture::getDepth(depth, x, y) == texture::getDepth(rows.depth, x, y));
+        }
+    }
+
+    destroyFrame(blocks);
+    destroyFrame(rows);
+    texture::destroy(depth);
+}
+
+TEST_CASE("binned tiles keep triangles in submission order", "[raster]") {
+    const int width = 96, height = 61, rows = 7;
+
+    // more triangles than one binning range, all at the same depth so later ones paint over
+    // earlier ones and any reordering shows
+    std::vector<vec3> vertices;
+    std::vector<u32> indices;
+    u32 seed = 1;
+    auto next = [&](float range) {
+        seed = seed * 1664525u + 1013904223u;
+        return float(seed >> 8) / float(1 << 24) * range;
+    };
+    for (u32 i = 0; i < 3 * 5000; i++) {
+        vertices.push_back(vec3(next(width + 20.f) - 10.f, next(height + 20.f) - 10.f, 0.5f));
+        indices.push_back(i);
+    }
+    std::vector<color> colors;
+    for (int i = 0; i < 7; i++) {
+        colors.push_back(color(u8(30 * i), u8(255 - 30 * i), u8(50 + 20 * i)));
+    }
+
+    auto triangles = raster::setupTriangles(vertices, indices, {0, 0, width, height});
+    auto reference = createFrame(width, height);
+    texture::clear(reference.depth, vec3(1.f));
+    raster::drawTriangles(reference.target, triangles, colors);
+
+    raster::binTriangles(triangles, rows, height);
+    REQUIRE(triangles.binStarts.size() == (height + rows - 1) / rows + 1);
+    for (size_t band = 0; band + 1 < triangles.binStarts.size(); band++) {
+        std::vector<u32> expected;
+        for (u32 t = 0; t < triangles.index.size(); t++) {
+            if (triangles.minY[t] < int(band + 1) * rows && triangles.maxY[t] >= int(band) * rows) {
+                expected.push_back(t);
+            }
+        }
+        std::vector<u32> binned(
+                triangles.binned.begin() + triangles.binStarts[band],
+                triangles.binned.begin() + triangles.binStarts[band + 1]
+        );
+        REQUIRE(binned == expected);
+    }
+
+    auto tiled = createFrame(width, height);
+    texture::clear(tiled.depth, vec3(1.f));
+    for (int y = 0; y < height; y += rows) {
+        auto target    = tiled.target;
+        target.scissor = {0, y, width, std::min(y + rows, height)};
+        raster::drawTriangles(target, triangles, colors);
+    }
+
+    auto* a = static_cast<u32*>(reference.color.data);
+    auto* b = static_cast<u32*>(tiled.color.data);
+    REQUIRE(std::equal(a, a + reference.color.stride * height, b));
+
+    destroyFrame(reference);
+    destroyFrame(tiled);
+}
+
+TEST_CASE("lines step one pixel along their longer axis", "[raster][lines]") {
+    auto f = createFrame(32, 24);
+
+    std::vector<vec3> vertices = {{2.5f, 3.5f, 0}, {20.5f, 3.5f, 0}, {1.5f, 6.5f, 0}, {10.5f, 22.5f, 0}};
+    raster::drawLines(f.target, vertices, {0, 1, 2, 3}, {color(255, 0, 0), color(0, 255, 0)}, false);
+
+    // 19 pixels across, 17 down with one per row
+    int red = 0, green = 0;
+    for (int y = 0; y < 24; y++) {
+        int row = 0;
+        for (int x = 0; x < 32; x++) {
+            auto col = texture::getPixel(f.color, x, y);
+            red += col.r == 255;
+            green += col.g == 255;
+            row += col.g == 255;
+        }
+        REQUIRE(row == (y >= 6 && y <= 22));
+    }
+    REQUIRE(red == 19);
+    REQUIRE(green == 17);
+    REQUIRE(texture::getPixel(f.color, 2, 3).r == 255);
+    REQUIRE(texture::getPixel(f.color, 20, 3).r == 255);
+    REQUIRE(texture::getPixel(f.color, 10, 22).g == 255);
+
+    destroyFrame(f);
+}
+
+TEST_CASE("tiles split lines without gaps or overlaps", "[raster][lines]") {
+    const int width = 64, height = 48;
+
+    // a fan of segments from inside and outside the image, a mesh edge list among them
+    std::vector<vec3> vertices = {{31.3f, 23.7f, 0.f}};
+    std::vector<u32> indices;
+    for (int i = 0; i < 40; i++) {
+        auto angle = float(i) * 0.157f;
+        vertices.push_back(vec3(31.3f + std::cos(angle) * (20.f + i * 1.5f), 23.7f + std::sin(angle) * (20.f + i * 1.5f), 0.f));
+        indices.push_back(0);
+        indices.push_back(u32(i + 1));
+    }
+    auto edges = raster::wireframeEdges({1, 2, 3, 2, 3, 4, 4, 3, 5});
+    REQUIRE(edges.size() == 2 * 7);
+    indices.insert(indices.end(), edges.begin(), edges.end());
+
+    // every line pixel counted, so a pixel drawn twice would show
+    auto count = [&](int rows) {
+        auto f     = createFrame(width, height);
+        auto lines = raster::setupLines(vertices, indices, {0, 0, width, height});
+        std::vector<int> hits(width * height);
+        for (int top = 0; top < height; top += rows) {
+            f.target.scissor = {0, top, width, top + rows};
+            texture::clear(f.color, color{});
+            raster::drawLines(f.target, lines, {color(255, 255, 255)}, false);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    hits[y * width + x] += texture::getPixel(f.color, x, y).r != 0;
+                }
+            }
+        }
+        destroyFrame(f);
+        return hits;
+    };
+
+    auto whole = count(height);
+    REQUIRE(*std::max_element(whole.begin(), whole.end()) == 1);
+    REQUIRE(count(5) == whole);
+}
+
+TEST_CASE("tiles draw many lines and points like the whole image", "[raster][lines]") {
+    const int width = 96, height = 64;
+
+    // enough of both for several setup ranges, some reaching past the image
+    std::vector<vec3> vertices;
+    std::vector<u32> indices;
+    u32 seed = 7;
+    auto next = [&](float range) {
+        seed = seed * 1664525u + 1013904223u;
+        return float(seed >> 8) / float(1 << 24) * range;
+    };
+    for (u32 i = 0; i < 9000; i++) {
+        vertices.push_back(vec3(next(width + 20.f) - 10.f, next(height + 20.f) - 10.f, next(1.f)));
+    }
+    for (u32 i = 0; i + 1 < 9000; i++) {
+        indices.push_back(i);
+        indices.push_back(u32(next(9000.f)));
+    }
+    auto lines  = raster::setupLines(vertices, indices, {0, 0, width, height});
+    auto points = raster::setupPoints(vertices, {0, 0, width, height}, 3);
+    REQUIRE(std::is_sorted(lines.begin(), lines.end(), [](auto& a, auto& b) { return a.area.minY < b.area.minY; }));
+
+    auto draw = [&](int rows) {
+        auto f = createFrame(width, height);
+        texture::clear(f.color, color{});
+        for (int top = 0; top < height; top += rows) {
+            f.target.scissor = {0, top, width, top + rows};
+            raster::drawLines(f.target, lines, {color(255, 0, 0), color(0, 0, 255)}, false);
+            raster::drawPoints(f.target, points, {color(0, 255, 0), color(255, 255, 0)}, false);
+        }
+        std::vector<color> ret;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                ret.push_back(texture::getPixel(f.color, x, y));
+            }
+        }
+        destroyFrame(f);
+        return ret;
+    };
+
+    auto whole = draw(height);
+    REQUIRE(draw(5) == whole);
+    REQUIRE(draw(1) == whole);
+
+    // the points alone, straight from the vertices
+    auto f = createFrame(width, height);
+    texture::clear(f.color, color{});
+    raster::drawPoints(f.target, vertices, {color(0, 255, 0), color(255, 255, 0)}, 3, false);
+    auto direct = createFrame(width, height);
+    texture::clear(direct.color, color{});
+    for (int top = 0; top < height; top += 7) {
+        direct.target.scissor = {0, top, width, top + 7};
+        raster::drawPoints(direct.target, points, {color(0, 255, 0), color(255, 255, 0)}, false);
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            REQUIRE(texture::getPixel(f.color, x, y) == texture::getPixel(direct.color, x, y));
+        }
+    }
+    destroyFrame(f);
+    destroyFrame(direct);
+}
+
+TEST_CASE("lines and points through vertices at infinity are dropped", "[raster][lines]") {
+    // what a vertex at or behind the camera divides to, next to ordinary ones
+    auto inf = std::numeric_limits<float>::infinity();
+    auto nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<vec3> vertices = {
+            {2.f, 2.f, 0.5f}, {10.f, 2.f, 0.5f}, {inf, 3.f, 0.5f}, {nan, nan, 0.5f}, {-3e38f, 5.f, 0.5f}, {3e38f, 5.f, 0.5f},
+    };
+    std::vector<u32> indices = {0, 1, 0, 2, 3, 1, 4, 5};
+
+    // the last one's ends are finite, their difference is not
+    auto lines = raster::setupLines(vertices, indices, {0, 0, 16, 16});
+    REQUIRE(lines.size() == 1);
+    REQUIRE(lines[0].index == 0);
+    REQUIRE(lines[0].last - lines[0].first == 8);
+
+    auto points = raster::setupPoints(vertices, {0, 0, 16, 16}, 3);
+    REQUIRE(points.size() == 2);
+    REQUIRE(points[0].index == 0);
+    REQUIRE(points[1].index == 1);
+}
+
+TEST_CASE("overlays are depth tested without writing depth", "[raster][lines]") {
+    auto f = createFrame(16, 16);
+
+    // a surface at depth 0.5 over the left half
+    std::vector<vec3> surface = {{0, 0, 0.5f}, {8, 0, 0.5f}, {8, 16, 0.5f}, {0, 16, 0.5f}};
+    raster::drawTriangles(f.target, surface, {0, 1, 2, 0, 2, 3}, {color(0, 0, 255)});
+
+    // the far line only shows right of it, the one on the surface itself shows everywhere
+    std::vector<vec3> vertices = {{0.5f, 4.5f, 0.7f}, {15.5f, 4.5f, 0.7f}, {0.5f, 8.5f, 0.5f}, {15.5f, 8.5f, 0.5f}};
+    raster::drawLines(f.target, vertices, {0, 1, 2, 3}, {color(255, 0, 0)});
+    REQUIRE(texture::getPixel(f.color, 3, 4).b == 255);
+    REQUIRE(texture::getPixel(f.color, 12, 4).r == 255);
+    REQUIRE(texture::getPixel(f.color, 3, 8).r == 255);
+    REQUIRE(texture::getDepth(f.depth, 12, 4) == 1.f);
+
+    raster::drawPoints(f.target, {vec3(12.f, 12.f, 0.9f), vec3(4.f, 12.f, 0.9f)}, {color(0, 255, 0)}, 2);
+    REQUIRE(texture::getPixel(f.color, 11, 11).g == 255);
+    REQUIRE(texture::getPixel(f.color, 12, 12).g == 255);
+    REQUIRE(texture::getPixel(f.color, 13, 12).g == 0);
+    REQUIRE(texture::getPixel(f.color, 4, 12).g == 0);
+
+    destroyFrame(f);
+}
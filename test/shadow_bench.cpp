@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench.hpp"
+#include "jobs.hpp"
+#include "msaa.hpp"
+#include "raster.hpp"
+#include "shadow.hpp"
+#include "math/transform.hpp"
+
+#include <vector>
+
+using namespace sfr;
+
+// one thread, so the rows compare the work of each stage whatever the machine's core count
+static const size_t Threads = 1;
+
+// the frame main draws: 1280x720 at 4x msaa in tiles of 90 rows, three 512x512 cascades
+static const int Width    = 1280;
+static const int Height   = 720;
+static const int Samples  = 4;
+static const int TileRows = Height / 8;
+
+// a floor and an 8x8 field of boxes of a few heights, seen from above and behind
+static void scene(std::vector<vec3>& vertices, std::vector<u32>& indices) {
+    auto quad = [&](const vec3& a, const vec3& b, const vec3& c, const vec3& d) {
+        auto first = u32(vertices.size());
+        vertices.insert(vertices.end(), {a, b, c, d});
+        for (auto i: {0u, 1u, 2u, 0u, 2u, 3u}) {
+            indices.push_back(first + i);
+        }
+    };
+
+    quad({-8.f, 0.f, -8.f}, {8.f, 0.f, -8.f}, {8.f, 0.f, 8.f}, {-8.f, 0.f, 8.f});
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            auto x = 2.f * i - 7.f, z = 2.f * j - 7.f;
+            auto h = 0.5f + 0.25f * float((i * 3 + j) % 4);
+            vec3 p[8];
+            for (int k = 0; k < 8; k++) {
+                p[k] = vec3(x + (k & 1 ? 0.4f : -0.4f), k & 2 ? h : 0.f, z + (k & 4 ? 0.4f : -0.4f));
+            }
+            quad(p[0], p[1], p[3], p[2]);
+            quad(p[4], p[6], p[7], p[5]);
+            quad(p[0], p[4], p[5], p[1]);
+            quad(p[2], p[3], p[7], p[6]);
+            quad(p[0], p[2], p[6], p[4]);
+            quad(p[1], p[5], p[7], p[3]);
+        }
+    }
+}
+
+// body over every tile of the frame, as the graph runs a tiled pass
+template <typename F>
+static void tiles(F&& body) {
+    jobs::parallelFor(size_t((Height + TileRows - 1) / TileRows), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            body(texture::rect{0, int(i) * TileRows, Width, std::min(int(i + 1) * TileRows, Height)});
+        }
+    });
+}
+
+// Shadows against the main view they darken: rendering the cascades and applying them over the
+// multisampled frame, next to clearing, shading and resolving that frame. A row is a whole
+// frame's worth of its stage, timed once per run.
+TEST_CASE("shadow cost against the main view", "[shadow][bench]") {
+    auto& suite = bench::baselines();
+    jobs::setThreads(Threads);
+
+    std::vector<vec3> world;
+    std::vector<u32> indices;
+    scene(world, indices);
+
+    auto toScreen       = viewport({-1.f, -1.f, 2.f, 2.f}, {0.f, 0.f, float(Width), float(Height)});
+    auto projection     = perspective(60.f * float(M_PI / 180.f), float(Width) / Height, 0.1f, 100.f);
+    auto viewProjection = projection * view(vec3(0.f, 6.f, 10.f), normalize(vec3(0.f, 0.5f, 1.f)), vec3(1.f, 0.f, 0.f), normalize(vec3(0.f, 1.f, -0.5f)));
+    auto screenToWorld  = inverse(toScreen * viewProjection);
+
+    std::vector<vec3> screen;
+    for (auto& v: world) {
+        auto clip = viewProjection * vec4(v, 1.f);
+        screen.push_back(vec3(toScreen * vec4(clip.x / clip.w, clip.y / clip.w, clip.z / clip.w, 1.f)));
+    }
+    auto triangles = raster::setupTriangles(screen, indices, {0, 0, Width, Height});
+    raster::binTriangles(triangles, TileRows, Height);
+
+    auto colorTex = texture::create(Width, Height, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(Width, Height, texture::Depth);
+    auto msaa     = msaa::create(Width, Height, Samples, texture::BGRA8);
+    auto shadow   = shadow::create(512, 3, vec3(-0.4f, -1.f, -0.6f));
+    const std::vector<color> colors = {{200, 200, 200}, {150, 150, 150}};
+
+    suite.run("main view 1280x720 4x msaa", [&] {
+        tiles([&](const texture::rect& tile) {
+            msaa::clear(msaa, color{}, tile);
+            raster::target_data target{&colorTex, &depthTex, &msaa, tile};
+            raster::drawTriangles(target, triangles, colors);
+            msaa::resolve(msaa, colorTex, tile);
+        });
+    }, 1);
+
+    suite.run("shadow cascades 3x512", [&] {
+        shadow::render(shadow, viewProjection, 0.1f, 100.f, world, indices);
+    }, 1);
+
+    // over the shaded samples the main view row left
+    suite.run("shadow apply 1280x720 4x msaa", [&] {
+        tiles([&](const texture::rect& tile) {
+            shadow::apply(shadow, screenToWorld, msaa, tile);
+        });
+    }, 1);
+
+    bench::keep(msaa.colors);
+    shadow::destroy(shadow);
+    msaa::destroy(msaa);
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+}
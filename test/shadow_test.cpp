@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "shadow.hpp"
+#include "raster.hpp"
+#include "math/transform.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace sfr;
+
+static const int Size = 96;
+
+// a floor at height 0 and a square hovering 2 units above its middle
+static const std::vector<vec3> scene = {
+        {-4.f, 0.f, -4.f}, {4.f, 0.f, -4.f}, {4.f, 0.f, 4.f}, {-4.f, 0.f, 4.f},
+        {-0.5f, 2.f, -0.5f}, {0.5f, 2.f, -0.5f}, {0.5f, 2.f, 0.5f}, {-0.5f, 2.f, 0.5f},
+};
+static const std::vector<u32> indices = {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+
+// straight above the floor, looking down
+static mat4 camera() {
+    auto projection = perspective(60.f * float(M_PI / 180.f), 1.f, 0.1f, 20.f);
+    return projection * view(vec3(0.f, 6.f, 0.f), vec3(0.f, 1.f, 0.f), vec3(1.f, 0.f, 0.f), vec3(0.f, 0.f, -1.f));
+}
+
+static mat4 screen() {
+    return viewport({-1, -1, 2, 2}, {0, 0, float(Size), float(Size)});
+}
+
+static std::vector<vec3> project(const mat4& viewProjection) {
+    std::vector<vec3> ret;
+    for (auto& v: scene) {
+        auto clip = viewProjection * vec4(v, 1.f);
+        ret.push_back(vec3(screen() * vec4(clip.x / clip.w, clip.y / clip.w, clip.z / clip.w, 1.f)));
+    }
+    return ret;
+}
+
+static vec3 worldAt(const mat4& screenToWorld, const texture::texture_data& depthTex, int x, int y) {
+    auto depth = static_cast<const float*>(depthTex.data)[y * depthTex.stride + x];
+    auto p     = screenToWorld * vec4(x + 0.5f, y + 0.5f, depth, 1.f);
+    return vec3(p.x / p.w, p.y / p.w, p.z / p.w);
+}
+
+TEST_CASE("casters darken what lies behind them from the light", "[shadow]") {
+    auto viewProjection = camera();
+    auto screenToWorld  = inverse(screen() * viewProjection);
+
+    // the square's shadow lands 1 unit further along x, over 0.5 < x < 1.5
+    auto shadow = shadow::create(256, 3, vec3(0.5f, -1.f, 0.f));
+    shadow::render(shadow, viewProjection, 0.1f, 20.f, scene, indices);
+    REQUIRE(shadow.cascades.back().splitDepth == 1.f);
+
+    auto colorTex = texture::create(Size, Size, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(Size, Size, texture::Depth);
+    raster::target_data target{&colorTex, &depthTex, nullptr};
+    raster::drawTriangles(target, project(viewProjection), indices, {color(200, 200, 200)});
+    shadow::apply(shadow, screenToWorld, colorTex, depthTex, {0, 0, Size, Size});
+
+    int shadowed = 0;
+    for (int y = 0; y < Size; y++) {
+        for (int x = 0; x < Size; x++) {
+            auto p   = worldAt(screenToWorld, depthTex, x, y);
+            auto col = texture::getPixel(colorTex, x, y);
+            if (p.y > 1.f) {
+                // the caster itself is lit
+                REQUIRE(col.r == 200);
+            } else if (p.x > 0.7f && p.x < 1.3f && std::abs(p.z) < 0.3f) {
+                // ambient light only, up to the rounding of the 8 bit scale
+                REQUIRE(std::abs(col.r - 80) <= 1);
+                shadowed++;
+            } else if (p.x < 0.3f || p.x > 1.7f || std::abs(p.z) > 0.7f) {
+                // the bias keeps the floor from shadowing itself
+                REQUIRE(col.r == 200);
+            }
+            REQUIRE(col.r == col.g);
+        }
+    }
+    REQUIRE(shadowed > 0);
+
+    texture::destroy(colorTex);
+    texture::destroy(depthTex);
+    shadow::destroy(shadow);
+}
+
+TEST_CASE("multisampled targets are shadowed before the resolve", "[shadow][msaa]") {
+    auto viewProjection = camera();
+    auto screenToWorld  = inverse(screen() * viewProjection);
+
+    auto shadow = shadow::create(256, 2, vec3(0.5f, -1.f, 0.f));
+    shadow::render(shadow, viewProjection, 0.1f, 20.f, scene, indices);
+
+    auto vertices = project(viewProjection);
+    auto single   = texture::create(Size, Size, texture::Color, texture::BGRA8);
+    auto resolved = texture::create(Size, Size, texture::Color, texture::BGRA8);
+    auto depthTex = texture::create(Size, Size, texture::Depth);
+    auto msaa     = msaa::create(Size, Size, 4, texture::BGRA8);
+
+    raster::target_data target{&single, &depthTex, nullptr};
+    raster::drawTriangles(target, vertices, indices, {color(200, 200, 200)});
+    shadow::apply(shadow, screenToWorld, single, depthTex, {0, 0, Size, Size});
+
+    target.msaa = &msaa;
+    raster::drawTriangles(target, vertices, indices, {color(200, 200, 200)});
+    shadow::apply(shadow, screenToWorld, msaa, {0, 0, Size, Size});
+    msaa::resolve(msaa, resolved);
+
+    // pixels away from the caster's edges hold one sample value matching the single sample image
+    int dark = 0;
+    for (int y = 0; y < Size; y++) {
+        for (int x = 0; x < Size; x++) {
+            if (msaa.uniform[y * msaa.stride + x]) {
+                REQUIRE(texture::getPixel(resolved, x, y).r == texture::getPixel(single, x, y).r);
+            }
+            dark += std::abs(texture::getPixel(resolved, x, y).r - 80) <= 1;
+        }
+    }
+    REQUIRE(dark > 0);
+
+    msaa::destroy(msaa);
+    texture::destroy(single);
+    texture::destroy(resolved);
+    texture::destroy(depthTex);
+    shadow::destroy(shadow);
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "skinning.hpp"
+#include "math/quat.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace sfr;
+
+// a strip of vertices along x, bent by two joints between which the weights fade
+static mesh::mesh_data strip(size_t count) {
+    mesh::mesh_data mesh;
+    for (size_t i = 0; i < count; i++) {
+        float t = float(i) / float(count - 1);
+        mesh.vertices.push_back(vec3(4.f * t, 0.1f * float(i % 3), -0.5f));
+        mesh.joints.push_back({0, 1, u16(i % 3 == 0 ? 2 : 0), 0});
+        mesh.weights.push_back(i % 3 == 0 ? vec4(0.5f * (1.f - t), 0.5f * t, 0.5f, 0.f) : vec4(1.f - t, t, 0.f, 0.f));
+    }
+    return mesh;
+}
+
+// the blend one vertex at a time through the dual quaternion type
+static vec3 reference(const mesh::mesh_data& mesh, const std::vector<dualquat>& palette, size_t i) {
+    auto pivot = palette[mesh.joints[i][0]];
+    auto sum   = mesh.weights[i][0] * pivot;
+    for (int k = 1; k < 4; k++) {
+        auto dq     = palette[mesh.joints[i][k]];
+        auto weight = mesh.weights[i][k];
+        sum         = sum + (dot(pivot.real, dq.real) < 0.f ? -weight : weight) * dq;
+    }
+    return transformPoint(normalize(sum), mesh.vertices[i]);
+}
+
+TEST_CASE("skinning matches the per vertex blend", "[skinning]") {
+    // joint 2 flipped to -q, the same transform, which the blend has to see through
+    std::vector<dualquat> palette = {
+            dualquat(angleAxis(10.f, vec3(0.f, 0.f, 1.f)), vec3(0.f, 1.f, 0.f)),
+            dualquat(angleAxis(80.f, vec3(0.f, 0.f, 1.f)), vec3(1.f, 0.f, 2.f)),
+            -1.f * dualquat(angleAxis(-30.f, vec3(1.f, 0.f, 0.f)), vec3(0.f, 0.f, 0.f)),
+    };
+
+    // not a multiple of 8 or of the job size, the tails go through the narrow paths
+    for (size_t count: {5, 37, 5003}) {
+        auto mesh = strip(count);
+        std::vector<vec3> out(count);
+        skinning::skin(mesh, palette, out);
+
+        for (size_t i = 0; i < count; i++) {
+            auto expected = reference(mesh, palette, i);
+            REQUIRE(std::abs(out[i].x - expected.x) < 1e-4f);
+            REQUIRE(std::abs(out[i].y - expected.y) < 1e-4f);
+            REQUIRE(std::abs(out[i].z - expected.z) < 1e-4f);
+        }
+    }
+}
+
+TEST_CASE("skinning leaves rigid meshes alone", "[skinning]") {
+    auto mesh = strip(20);
+    mesh.joints.clear();
+    mesh.weights.clear();
+
+    std::vector<dualquat> palette = {dualquat(angleAxis(90.f, vec3(0.f, 1.f, 0.f)), vec3(3.f))};
+    std::vector<vec3> out(20);
+    skinning::skin(mesh, palette, out);
+    for (size_t i = 0; i < 20; i++) {
+        REQUIRE(out[i] == mesh.vertices[i]);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tuning.hpp"
+#include "jobs.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+using namespace sfr;
+
+static const std::string Path = "tuning_test_cache.txt";
+
+TEST_CASE("settings are only read back on the machine and resolution they were saved for", "[tuning]") {
+    std::remove(Path.c_str());
+    tuning::settings read{0, 0};
+    REQUIRE_FALSE(tuning::load(Path, 1280, 720, read));
+
+    tuning::save(Path, 1280, 720, {45, 3});
+    REQUIRE(tuning::load(Path, 1280, 720, read));
+    REQUIRE(read.tileRows == 45);
+    REQUIRE(read.threads == 3);
+
+    tuning::settings other{7, 7};
+    REQUIRE_FALSE(tuning::load(Path, 1920, 1080, other));
+    REQUIRE(other.tileRows == 7);
+
+    // calibrated on another machine
+    {
+        std::ofstream out(Path);
+        out << "signature=cores 1024, l2 1, sse4.1, 1280x720\ntileRows=45\nthreads=3\n";
+    }
+    REQUIRE_FALSE(tuning::load(Path, 1280, 720, read));
+
+    // or with the pool limited to other cores
+    tuning::save(Path, 1280, 720, {45, 3});
+    auto* threads = std::getenv("SFR_THREADS");
+    std::string previous = threads ? threads : "";
+    setenv("SFR_THREADS", std::to_string(jobs::defaultThreads() + 1).c_str(), 1);
+    REQUIRE_FALSE(tuning::load(Path, 1280, 720, read));
+    if (threads) {
+        setenv("SFR_THREADS", previous.c_str(), 1);
+    } else {
+        unsetenv("SFR_THREADS");
+    }
+    REQUIRE(tuning::load(Path, 1280, 720, read));
+    std::remove(Path.c_str());
+}
+
+TEST_CASE("calibration picks one of the candidates and leaves the pool as it was", "[tuning]") {
+    auto threads = jobs::workerCount();
+    auto tuned   = tuning::calibrate(320, 180);
+
+    REQUIRE(tuned.tileRows >= 8);
+    REQUIRE(tuned.tileRows <= 90);
+    REQUIRE(tuned.threads >= 1);
+    REQUIRE(tuned.threads <= jobs::defaultThreads());
+    REQUIRE(jobs::workerCount() == threads);
+
+    std::atomic<int> items = 0;
+    jobs::parallelFor(1000, 7, [&](size_t begin, size_t end) { items += int(end - begin); });
+    REQUIRE(items == 1000);
+}
+
+TEST_CASE("tuning calibrates once and reuses the saved settings", "[tuning]") {
+    std::remove(Path.c_str());
+    auto threads = jobs::workerCount();
+
+    auto first = tuning::tune(Path, 320, 180);
+    REQUIRE(jobs::workerCount() == first.threads);
+
+    // the cache is read back without calibrating again
+    tuning::save(Path, 320, 180, {12, first.threads});
+    auto second = tuning::tune(Path, 320, 180);
+    REQUIRE(second.tileRows == 12);
+
+    jobs::setThreads(threads);
+    std::remove(Path.c_str());
+}
@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench.hpp"
+#include "math/vec.hpp"
+#include "math/wide.hpp"
+
+#include <span>
+#include <string>
+
+using bench::Count;
+
+template <typename V>
+static std::span<V> sampleVectors(bench::arrays& memory, float offset) {
+    auto ret = memory.make<V>(Count);
+    for (size_t i = 0; i < Count; i++) {
+        for (size_t c = 0; c < V::size; c++) {
+            ret[i][c] = offset + 0.5f * c + 0.01f * i;
+        }
+    }
+    return ret;
+}
+
+// Every operator of V, one row each. float vectors go through the fast detail::compute*
+// specialisations, double ones through the scalar loops.
+template <typename V>
+static void benchmarkVec(const std::string& name) {
+    auto& suite = bench::baselines();
+
+    bench::arrays memory;
+    auto a       = sampleVectors<V>(memory, 1.f);
+    auto b       = sampleVectors<V>(memory, 2.f);
+    auto out     = memory.make<V>(Count);
+    auto scalars = memory.make<float>(Count);
+    // a divisor the compiler cannot turn into a multiply by its reciprocal
+    auto divisor = memory.make<float>(Count, 3.f);
+
+    auto row = [&](const char* op, auto&& body) {
+        suite.run(name + " " + op, [&] {
+            for (size_t i = 0; i < Count; i++) {
+                body(i);
+            }
+            bench::keep(out);
+            bench::keep(scalars);
+        });
+    };
+
+    row("+", [&](size_t i) { out[i] = a[i] + b[i]; });
+    row("-", [&](size_t i) { out[i] = a[i] - b[i]; });
+    row("s * v", [&](size_t i) { out[i] = 0.5f * a[i]; });
+    row("v * s", [&](size_t i) { out[i] = a[i] * 0.5f; });
+    row("v / s", [&](size_t i) { out[i] = a[i] / divisor[i]; });
+    // the compound rows start from a each time, repeated runs would otherwise drift into denormals
+    row("+=", [&](size_t i) { (out[i] = a[i]) += b[i]; });
+    row("-=", [&](size_t i) { (out[i] = a[i]) -= b[i]; });
+    row("*=", [&](size_t i) { (out[i] = a[i]) *= 0.5f; });
+    row("/=", [&](size_t i) { (out[i] = a[i]) /= divisor[i]; });
+    row("==", [&](size_t i) { scalars[i] = a[i] == b[i]; });
+    row("!=", [&](size_t i) { scalars[i] = a[i] != b[i]; });
+    row("dot", [&](size_t i) { scalars[i] = dot(a[i], b[i]); });
+    row("length", [&](size_t i) { scalars[i] = length(a[i]); });
+    row("normalize", [&](size_t i) { out[i] = normalize(a[i]); });
+    row("fma", [&](size_t i) { out[i] = fma(a[i], b[i], a[i]); });
+
+    row("divide fast", [&](size_t i) { out[i] = divide<precision::fast>(a[i], divisor[i]); });
+    row("divide approximate", [&](size_t i) { out[i] = divide<precision::approximate>(a[i], divisor[i]); });
+    row("length fast", [&](size_t i) { scalars[i] = length<precision::fast>(a[i]); });
+    row("length approximate", [&](size_t i) { scalars[i] = length<precision::approximate>(a[i]); });
+    row("normalize fast", [&](size_t i) { out[i] = normalize<precision::fast>(a[i]); });
+    row("normalize approximate", [&](size_t i) { out[i] = normalize<precision::approximate>(a[i]); });
+}
+
+// The SoA form, Count vectors eight at a time.
+template <size_t Size>
+static void benchmarkWideVec(const std::string& name) {
+    using wide_type = wide_vec<float, Size, 8>;
+    const size_t batches = Count / 8;
+
+    auto& suite = bench::baselines();
+
+    bench::arrays memory;
+    auto vectorsA = sampleVectors<vec<float, Size>>(memory, 1.f);
+    auto vectorsB = sampleVectors<vec<float, Size>>(memory, 2.f);
+    auto a        = memory.make<wide_type>(batches);
+    auto b        = memory.make<wide_type>(batches);
+    auto out      = memory.make<wide_type>(batches);
+    auto scalars  = memory.make<floatx8>(batches, floatx8(0.f));
+    for (size_t i = 0; i < batches; i++) {
+        a[i] = wide_type::load(&vectorsA[i * 8]);
+        b[i] = wide_type::load(&vectorsB[i * 8]);
+    }
+    auto s = floatx8(0.5f);
+
+    auto row = [&](const char* op, auto&& body) {
+        suite.run(name + " " + op, [&] {
+            for (size_t i = 0; i < batches; i++) {
+                body(i);
+            }
+            bench::keep(out);
+            bench::keep(scalars);
+        });
+    };
+
+    row("+", [&](size_t i) { out[i] = a[i] + b[i]; });
+    row("-", [&](size_t i) { out[i] = a[i] - b[i]; });
+    row("*", [&](size_t i) { out[i] = a[i] * b[i]; });
+    row("v * s", [&](size_t i) { out[i] = a[i] * s; });
+    row("v / s", [&](size_t i) { out[i] = a[i] / b[i].data[0]; });
+    row("+=", [&](size_t i) { (out[i] = a[i]) += b[i]; });
+    row("negate", [&](size_t i) { out[i] = -a[i]; });
+    row("dot", [&](size_t i) { scalars[i] = dot(a[i], b[i]); });
+    row("length", [&](size_t i) { scalars[i] = length(a[i]); });
+    row("normalize", [&](size_t i) { out[i] = normalize(a[i]); });
+    row("normalize fast", [&](size_t i) { out[i] = normalize<precision::fast>(a[i]); });
+    row("normalize approximate", [&](size_t i) { out[i] = normalize<precision::approximate>(a[i]); });
+    row("divide fast", [&](size_t i) { out[i] = divide<precision::fast>(a[i], b[i].data[0]); });
+    row("min", [&](size_t i) { out[i] = min(a[i], b[i]); });
+    row("max", [&](size_t i) { out[i] = max(a[i], b[i]); });
+    row("select", [&](size_t i) { out[i] = select(a[i].data[0] < b[i].data[1], a[i], b[i]); });
+    if constexpr (Size == 3) {
+        row("cross", [&](size_t i) { out[i] = cross(a[i], b[i]); });
+    }
+}
+
+TEST_CASE("vec2 throughput", "[math][bench]") {
+    benchmarkVec<vec2>("vec2");
+    benchmarkVec<vec<double, 2>>("dvec2");
+    benchmarkWideVec<2>("vec2x8");
+}
+
+TEST_CASE("vec3 throughput", "[math][bench]") {
+    benchmarkVec<vec3>("vec3");
+    benchmarkVec<vec<double, 3>>("dvec3");
+    benchmarkWideVec<3>("vec3x8");
+}
+
+TEST_CASE("vec4 throughput", "[math][bench]") {
+    benchmarkVec<vec4>("vec4");
+    benchmarkVec<vec<double, 4>>("dvec4");
+    benchmarkWideVec<4>("vec4x8");
+}
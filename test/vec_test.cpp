@@ -2,6 +2,9 @@
 
 #include "math/vec.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 const float Epsilon = 0.001f;
 
 TEST_CASE("vec equality", "[math]") {
@@ -126,4 +129,65 @@ TEST_CASE("vec normalization", "[math]") {
     auto baseline2 = vec3(0.445f, 0.283f, 0.849f);
     REQUIRE(res1 == baseline1);
     REQUIRE(res2 == baseline2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("vec storage is register sized", "[math]") {
+    REQUIRE(sizeof(vec3) == 16);
+    REQUIRE(alignof(vec3) == 16);
+    REQUIRE(sizeof(vec<unsigned char, 3>) == 3);
+
+    // garbage in the padding lane never leaks into comparisons or reductions
+    vec3 a(1.f, 2.f, 3.f);
+    vec3 b(1.f, 2.f, 3.f);
+    b.data.data[3] = 100.f;
+    REQUIRE(a == b);
+    REQUIRE_FALSE(a != b);
+    REQUIRE(std::abs(dot(a, b) - 14.f) < Epsilon);
+    REQUIRE(std::abs(length(b) - std::sqrt(14.f)) < Epsilon);
+}
+
+TEST_CASE("vec fused multiply add", "[math]") {
+    vec3 a(1.f, 2.f, 3.f);
+    vec3 b(0.5f, -1.f, 2.f);
+    vec3 c(4.f, 4.f, 4.f);
+
+    REQUIRE(fma(a, b, c) == vec3(4.5f, 2.f, 10.f));
+    REQUIRE(fma(a, 2.f, c) == vec3(6.f, 8.f, 10.f));
+    REQUIRE(fma(vec<int, 2>(2, 3), vec<int, 2>(4, 5), vec<int, 2>(1, 1)) == vec<int, 2>(9, 16));
+}
+
+// Largest relative error over a sweep of 2^-20 to 2^20, see math/precision.hpp for the bounds.
+template <precision P>
+static void requirePrecision(double bound) {
+    double divideError = 0, lengthError = 0, normalizeError = 0;
+    for (int i = 0; i < 20000; i++) {
+        float x = std::exp2(-20.f + 40.f * i / 20000.f) * (1.f + 0.05f * (i % 7));
+
+        auto quotient = divide<P>(vec4(1.f, -2.f, 3.f, 0.5f), x);
+        divideError   = std::max(divideError, std::abs(quotient[1] * double(x) + 2.0) / 2.0);
+
+        vec3 v(x, 1.f + 0.3f * (i % 11), -0.5f * (i % 5));
+        double len  = std::sqrt(double(v.x) * v.x + double(v.y) * v.y + double(v.z) * v.z);
+        lengthError = std::max(lengthError, std::abs(length<P>(v) - len) / len);
+
+        auto n = normalize<P>(v);
+        for (int c = 0; c < 3; c++) {
+            normalizeError = std::max(normalizeError, std::abs(n[c] - v[c] / len));
+        }
+    }
+
+    REQUIRE(divideError < bound);
+    REQUIRE(lengthError < bound);
+    REQUIRE(normalizeError < bound);
+}
+
+TEST_CASE("vec precision policies stay within their bounds", "[math]") {
+    requirePrecision<precision::exact>(std::exp2(-22.0));
+    requirePrecision<precision::fast>(std::exp2(-21.0));
+    requirePrecision<precision::approximate>(1.5 * std::exp2(-12.0));
+
+    REQUIRE(length<precision::fast>(vec3(0.f)) == 0.f);
+    REQUIRE(length<precision::approximate>(vec3(0.f)) == 0.f);
+    REQUIRE(normalize<precision::exact>(vec3(3.f, 0.f, 4.f)) == normalize(vec3(3.f, 0.f, 4.f)));
+    REQUIRE(length(vec<double, 3>(3.0, 0.0, 4.0)) == 5.f);
+}
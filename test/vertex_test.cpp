@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "vertex.hpp"
+#include "kernels.hpp"
+#include "math/transform.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace sfr;
+
+static std::vector<vec3> cloud(size_t count) {
+    std::vector<vec3> ret;
+    for (size_t i = 0; i < count; i++) {
+        float t = float(i);
+        ret.push_back(vec3(std::sin(t) * 3.f, std::cos(t * 0.7f) * 2.f, -1.f - float(i % 97) * 0.1f));
+    }
+    return ret;
+}
+
+static bool same(const std::vector<vec3>& a, const std::vector<vec3>& b) {
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::memcmp(&a[i].x, &b[i].x, 3 * sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("ranges give the same bits as one pass over every vertex", "[vertex]") {
+    auto viewProjection = perspective(1.f, 16.f / 9.f, 0.1f, 100.f);
+    auto screen         = viewport({-1, -1, 2, 2}, {0, 0, 1280, 720});
+
+    for (int isa = kernels::SSE41; isa <= kernels::detect(); isa++) {
+        kernels::select(kernels::isa(isa));
+        auto& kernels = kernels::get();
+
+        // a range size, a vertex past it and tails that are not a whole register
+        for (size_t count: {1, 3, 4096, 4097, 20001}) {
+            auto vertices = cloud(count);
+            std::vector<vec3> clip(count), out(count), refClip(count), refOut(count);
+
+            vertex::project(viewProjection, screen, vertices, clip, out, precision::fast);
+            kernels.transformPoints(&viewProjection[0][0], &vertices[0].x, &refClip[0].x, count, true, precision::fast);
+            kernels.transformPoints(&screen[0][0], &refClip[0].x, &refOut[0].x, count, false, precision::exact);
+            REQUIRE(same(clip, refClip));
+            REQUIRE(same(out, refOut));
+
+            vertex::transform(screen, clip, out, false, precision::exact);
+            REQUIRE(same(out, refOut));
+        }
+    }
+    kernels::select(kernels::detect());
+}
+
+TEST_CASE("vertices land where the matrices put them", "[vertex]") {
+    auto screen = viewport({-1, -1, 2, 2}, {0, 0, 1280, 720});
+    std::vector<vec3> vertices = {{0.f, 0.f, 0.5f}, {1.f, 1.f, 0.f}, {-1.f, -1.f, 1.f}};
+    std::vector<vec3> clip(3), out(3);
+
+    vertex::project(mat4(1.f), screen, vertices, clip, out, precision::exact);
+    REQUIRE(out[0].x == 640.f);
+    REQUIRE(out[0].y == 360.f);
+    REQUIRE(out[1].x == 1280.f);
+    REQUIRE(out[2].y == 0.f);
+}
@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "math/wide.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+const float Epsilon = 0.001f;
+
+static bool approx(const vec3& a, const vec3& b) {
+    return std::abs(a.x - b.x) < Epsilon && std::abs(a.y - b.y) < Epsilon && std::abs(a.z - b.z) < Epsilon;
+}
+
+static bool approx(const vec4& a, const vec4& b) {
+    return approx(vec3(a), vec3(b)) && std::abs(a.w - b.w) < Epsilon;
+}
+
+static std::vector<vec3> sampleVectors(size_t count) {
+    std::vector<vec3> ret;
+    for (size_t i = 0; i < count; i++) {
+        ret.push_back(vec3(0.5f + i, 2.f - 0.25f * i, 1.f + 0.1f * i * i));
+    }
+    return ret;
+}
+
+TEST_CASE("wide arithmetic", "[math][wide]") {
+    float a[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    float b[8] = {8, 7, 6, 5, 4, 3, 2, 1};
+
+    auto x = floatx8::load(a);
+    auto y = floatx8::load(b);
+    auto sum  = x + y;
+    auto prod = x * y;
+    auto quot = x / y;
+    auto neg  = -x;
+    for (int i = 0; i < 8; i++) {
+        REQUIRE(sum[i] == 9.f);
+        REQUIRE(prod[i] == a[i] * b[i]);
+        REQUIRE(std::abs(quot[i] - a[i] / b[i]) < Epsilon);
+        REQUIRE(neg[i] == -a[i]);
+    }
+
+    auto lo = floatx4::load(a);
+    REQUIRE(std::abs(sqrt(lo)[3] - 2.f) < Epsilon);
+    REQUIRE(abs(-lo)[2] == 3.f);
+    REQUIRE(min(lo, floatx4(2.5f))[3] == 2.5f);
+    REQUIRE(max(lo, floatx4(2.5f))[0] == 2.5f);
+}
+
+TEST_CASE("wide masks and select", "[math][wide]") {
+    float a[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    auto x    = floatx8::load(a);
+    auto mask = x > floatx8(4.5f);
+    REQUIRE(bitmask(mask) == 0xF0);
+    REQUIRE(any(mask));
+    REQUIRE_FALSE(all(mask));
+    REQUIRE(all(x >= floatx8(1.f)));
+    REQUIRE_FALSE(any(x == floatx8(0.f)));
+
+    auto picked = select(mask, x, floatx8(0.f));
+    REQUIRE(picked[3] == 0.f);
+    REQUIRE(picked[4] == 5.f);
+
+    auto lo = floatx4::load(a);
+    REQUIRE(bitmask((lo < floatx4(2.f)) | (lo > floatx4(3.f))) == 0b1001);
+    REQUIRE(bitmask((lo <= floatx4(2.f)) & (lo != floatx4(1.f))) == 0b0010);
+}
+
+TEST_CASE("wide vec load and store", "[math][wide]") {
+    auto vectors = sampleVectors(7);
+
+    // a partial batch leaves the lanes past the end zero and the output untouched
+    auto batch = vec3x8::load(vectors.data(), vectors.size());
+    REQUIRE(batch.x[6] == vectors[6].x);
+    REQUIRE(batch.z[7] == 0.f);
+
+    std::vector<vec3> out(8, vec3(-1.f));
+    batch.store(out.data(), vectors.size());
+    for (size_t i = 0; i < vectors.size(); i++) {
+        REQUIRE(out[i] == vectors[i]);
+        REQUIRE(batch.lane(i) == vectors[i]);
+    }
+    REQUIRE(out[7] == vec3(-1.f));
+}
+
+TEST_CASE("wide vec matches scalar vec", "[math][wide]") {
+    auto us = sampleVectors(4);
+    auto vs = sampleVectors(8);
+    vs.erase(vs.begin(), vs.begin() + 4);
+
+    auto u = vec3x4::load(us.data());
+    auto v = vec3x4::load(vs.data());
+
+    auto sum      = u + v;
+    auto diff     = u - v;
+    auto scaled   = u * floatx4(2.f);
+    auto divided  = u / floatx4(2.f);
+    auto dots     = dot(u, v);
+    auto crosses  = cross(u, v);
+    auto lengths  = length(u);
+    auto normals  = normalize(u);
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(approx(sum.lane(i), us[i] + vs[i]));
+        REQUIRE(approx(diff.lane(i), us[i] - vs[i]));
+        REQUIRE(approx(scaled.lane(i), us[i] * 2.f));
+        REQUIRE(approx(divided.lane(i), us[i] / 2.f));
+        REQUIRE(std::abs(dots[i] - dot(us[i], vs[i])) < Epsilon);
+        REQUIRE(std::abs(lengths[i] - length(us[i])) < Epsilon);
+        REQUIRE(approx(normals.lane(i), normalize(us[i])));
+
+        auto& a = us[i];
+        auto& b = vs[i];
+        vec3 expected(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+        REQUIRE(approx(crosses.lane(i), expected));
+    }
+
+    auto picked = select(u.x < floatx4(2.f), u, v);
+    REQUIRE(picked.lane(0) == us[0]);
+    REQUIRE(picked.lane(3) == vs[3]);
+}
+
+TEST_CASE("mat4-wide vec4 multiplication", "[math][wide]") {
+    mat4 m;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            m[c][r] = float(c * 4 + r) * 0.5f - 3.f;
+        }
+    }
+
+    auto vectors = sampleVectors(8);
+    auto batch   = m * vec4x8(vec3x8::load(vectors.data()), 1.f);
+    for (int i = 0; i < 8; i++) {
+        REQUIRE(approx(batch.lane(i), m * vec4(vectors[i], 1.f)));
+    }
+
+    auto broadcast = vec4x4(vec4(1.f, 2.f, 3.f, 4.f));
+    REQUIRE(vec3x4(broadcast).lane(2) == vec3(1.f, 2.f, 3.f));
+}
+
+TEST_CASE("wide precision policies stay within their bounds", "[math][wide]") {
+    double errors[3][2] = {};
+    for (int i = 0; i < 20000; i += 8) {
+        alignas(32) float values[8];
+        for (int l = 0; l < 8; l++) {
+            values[l] = std::exp2(-20.f + 40.f * (i + l) / 20000.f);
+        }
+        auto x = floatx8::load(values);
+
+        floatx8 reciprocals[3] = {
+                rcp<precision::exact>(x), rcp<precision::fast>(x), rcp<precision::approximate>(x)
+        };
+        floatx8 reciprocalSqrts[3] = {
+                rsqrt<precision::exact>(x), rsqrt<precision::fast>(x), rsqrt<precision::approximate>(x)
+        };
+        for (int p = 0; p < 3; p++) {
+            for (int l = 0; l < 8; l++) {
+                double value = values[l];
+                errors[p][0] = std::max(errors[p][0], std::abs(reciprocals[p][l] * value - 1.0));
+                errors[p][1] = std::max(errors[p][1], std::abs(reciprocalSqrts[p][l] * std::sqrt(value) - 1.0));
+            }
+        }
+    }
+
+    double bounds[3] = {std::exp2(-22.0), std::exp2(-21.0), 1.5 * std::exp2(-12.0)};
+    for (int p = 0; p < 3; p++) {
+        REQUIRE(errors[p][0] < bounds[p]);
+        REQUIRE(errors[p][1] < bounds[p]);
+    }
+
+    auto vectors = sampleVectors(8);
+    auto batch   = vec3x8::load(vectors.data());
+    auto lengths = length<precision::fast>(batch);
+    auto units   = normalize<precision::approximate>(batch);
+    for (int i = 0; i < 8; i++) {
+        REQUIRE(std::abs(lengths[i] - length(vectors[i])) < Epsilon * length(vectors[i]));
+        REQUIRE(approx(units.lane(i), normalize(vectors[i])));
+    }
+    REQUIRE(length<precision::approximate>(vec3x8(floatx8(0.f)))[0] == 0.f);
+}